@@ -0,0 +1,122 @@
+// ============================================
+// Adaptive Sample Size
+// ============================================
+// A fixed CONC * 10 prompts is 40 requests at CONC=4, where the medians are
+// still noisy, and 1280 long requests at CONC=128, well past the point where
+// they stopped moving. With adaptive sampling the client keeps issuing
+// requests until the bootstrap confidence intervals of median TPOT, median
+// E2E latency and token throughput are all within `target_rel_ci` of their
+// estimates (half-width / estimate), with at least `min_prompts` completed
+// and at most the schedule length (NUM_PROMPTS becomes the cap).
+//
+// Throughput is bootstrapped through Little's law: at a fixed concurrency,
+// token throughput is proportional to sum(tokens) / sum(E2E latency) over
+// the completed requests, so the interval of that ratio, relative to its
+// estimate, is the throughput's.
+//
+// The check runs on the aggregator thread every few completions. Once it
+// passes, workers stop claiming prompts and the requests in flight finish,
+// so a run sends at most CONC more requests than the check saw.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+struct AdaptiveSampling {
+    bool enabled = false;
+    double target_rel_ci = 0.02;                // 95% CI half-width / estimate, for all three metrics
+    int min_prompts = 0;                        // completions before the first check
+    int resamples = 200;
+    unsigned int seed = 0;
+};
+
+struct ConvergenceState {
+    int samples = 0;                            // completions the last check saw
+    int checks = 0;
+    bool converged = false;
+    double tpot_rel_ci = std::numeric_limits<double>::infinity();
+    double e2el_rel_ci = std::numeric_limits<double>::infinity();
+    double tput_rel_ci = std::numeric_limits<double>::infinity();
+};
+
+// Median by selection, interpolated like loadgen_percentile(values, 50).
+// Reorders `values`.
+inline double adaptive_median(std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2 == 1) return upper;
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2.0;
+}
+
+// Half-width of the central 95% of `estimates`, relative to `point`.
+inline double bootstrap_rel_halfwidth(std::vector<double>& estimates, double point) {
+    if (estimates.size() < 2 || point <= 0) return std::numeric_limits<double>::infinity();
+    std::sort(estimates.begin(), estimates.end());
+    size_t lo = static_cast<size_t>(0.025 * (estimates.size() - 1));
+    size_t hi = static_cast<size_t>(std::ceil(0.975 * (estimates.size() - 1)));
+    return (estimates[hi] - estimates[lo]) / 2.0 / point;
+}
+
+// Samples of the completed requests: TPOT per request that decoded more than
+// one token, and (E2E latency, prompt + output tokens) per request.
+struct ConvergenceSamples {
+    std::vector<double> tpot_ms;
+    std::vector<double> e2el_ms;
+    std::vector<double> tokens;
+};
+
+inline ConvergenceState check_convergence(const ConvergenceSamples& s, const AdaptiveSampling& rule,
+                                          std::mt19937& rng, int checks_before) {
+    ConvergenceState st;
+    st.samples = static_cast<int>(s.e2el_ms.size());
+    st.checks = checks_before + 1;
+    if (s.tpot_ms.size() < 2 || s.e2el_ms.size() < 2) return st;
+
+    std::vector<double> scratch(s.tpot_ms);
+    double tpot_point = adaptive_median(scratch);
+    scratch = s.e2el_ms;
+    double e2el_point = adaptive_median(scratch);
+    double tok_sum = 0.0, e2el_sum = 0.0;
+    for (size_t i = 0; i < s.e2el_ms.size(); i++) {
+        tok_sum += s.tokens[i];
+        e2el_sum += s.e2el_ms[i];
+    }
+    double tput_point = e2el_sum > 0 ? tok_sum / e2el_sum : 0.0;
+
+    std::vector<double> tpot_est, e2el_est, tput_est;
+    tpot_est.reserve(rule.resamples);
+    e2el_est.reserve(rule.resamples);
+    tput_est.reserve(rule.resamples);
+    std::uniform_int_distribution<size_t> pick_tpot(0, s.tpot_ms.size() - 1);
+    std::uniform_int_distribution<size_t> pick_req(0, s.e2el_ms.size() - 1);
+    for (int b = 0; b < rule.resamples; b++) {
+        scratch.resize(s.tpot_ms.size());
+        for (double& v : scratch) v = s.tpot_ms[pick_tpot(rng)];
+        tpot_est.push_back(adaptive_median(scratch));
+
+        scratch.resize(s.e2el_ms.size());
+        double tok = 0.0, lat = 0.0;
+        for (double& v : scratch) {
+            size_t i = pick_req(rng);
+            v = s.e2el_ms[i];
+            tok += s.tokens[i];
+            lat += s.e2el_ms[i];
+        }
+        e2el_est.push_back(adaptive_median(scratch));
+        tput_est.push_back(lat > 0 ? tok / lat : 0.0);
+    }
+    st.tpot_rel_ci = bootstrap_rel_halfwidth(tpot_est, tpot_point);
+    st.e2el_rel_ci = bootstrap_rel_halfwidth(e2el_est, e2el_point);
+    st.tput_rel_ci = bootstrap_rel_halfwidth(tput_est, tput_point);
+    st.converged = st.tpot_rel_ci <= rule.target_rel_ci && st.e2el_rel_ci <= rule.target_rel_ci &&
+                   st.tput_rel_ci <= rule.target_rel_ci;
+    return st;
+}
@@ -0,0 +1,130 @@
+// ============================================
+// Open-Loop Arrival Scheduler
+// ============================================
+// Computes the intended send time of every request. The load generator issues
+// a request once its send time has passed AND a concurrency slot is free, so
+// `max_concurrency` still caps in-flight work while the arrival process sets
+// the offered load.
+//
+// Modes (ARRIVAL_MODE):
+//   inf       - all requests due at t=0; pure closed loop (the old default)
+//   poisson   - exponential inter-arrivals at REQUEST_RATE req/s
+//   gamma     - gamma inter-arrivals, shape=BURSTINESS, mean 1/REQUEST_RATE
+//               (BURSTINESS < 1 is burstier than Poisson, > 1 smoother)
+//   constant  - fixed 1/REQUEST_RATE spacing
+//   trace     - one arrival offset in seconds per line of ARRIVAL_TRACE
+//               (relative to the first line; '#' starts a comment)
+
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ArrivalConfig {
+    std::string mode = "inf";
+    double request_rate = std::numeric_limits<double>::infinity();
+    double burstiness = 1.0;
+    std::string trace_path;
+    unsigned int seed = 0;
+};
+
+inline bool is_valid_arrival_mode(const std::string& mode) {
+    return mode == "inf" || mode == "poisson" || mode == "gamma" || mode == "constant" || mode == "trace";
+}
+
+// Open-loop modes give every request an intended send time. In the closed loop
+// a request is due whenever a slot frees up, so there is no schedule to fall
+// behind and no coordinated omission to measure.
+inline bool arrival_is_open_loop(const ArrivalConfig& cfg) {
+    return cfg.mode != "inf";
+}
+
+// Human-readable description, e.g. "poisson @ 2.5 req/s".
+inline std::string describe_arrival(const ArrivalConfig& cfg) {
+    std::stringstream ss;
+    if (cfg.mode == "inf") {
+        ss << "inf (closed loop)";
+    } else if (cfg.mode == "trace") {
+        ss << "trace " << cfg.trace_path;
+    } else {
+        ss << cfg.mode << " @ " << cfg.request_rate << " req/s";
+        if (cfg.mode == "gamma") ss << ", burstiness " << cfg.burstiness;
+    }
+    return ss.str();
+}
+
+inline bool load_arrival_trace(const std::string& path, std::vector<double>& offsets, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = "cannot open arrival trace " + path;
+        return false;
+    }
+    std::string line;
+    double first = 0.0;
+    bool have_first = false;
+    while (std::getline(in, line)) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::stringstream ss(line);
+        double t;
+        if (!(ss >> t)) continue;
+        if (!have_first) {
+            first = t;
+            have_first = true;
+        }
+        if (!offsets.empty() && t - first < offsets.back()) {
+            err = "arrival trace " + path + " is not sorted by time";
+            return false;
+        }
+        offsets.push_back(t - first);
+    }
+    if (offsets.empty()) {
+        err = "arrival trace " + path + " contains no timestamps";
+        return false;
+    }
+    return true;
+}
+
+// Fills `offsets` with `n` send times in seconds from the start of the run.
+// For trace mode, `n` is clamped to the trace length.
+inline bool build_arrival_schedule(const ArrivalConfig& cfg, size_t n, std::vector<double>& offsets, std::string& err) {
+    offsets.clear();
+    if (!is_valid_arrival_mode(cfg.mode)) {
+        err = "unknown arrival mode '" + cfg.mode + "' (expected inf, poisson, gamma, constant or trace)";
+        return false;
+    }
+    if (cfg.mode == "inf") {
+        offsets.assign(n, 0.0);
+        return true;
+    }
+    if (cfg.mode == "trace") {
+        if (!load_arrival_trace(cfg.trace_path, offsets, err)) return false;
+        if (offsets.size() > n) offsets.resize(n);
+        return true;
+    }
+
+    if (!(cfg.request_rate > 0.0) || std::isinf(cfg.request_rate)) {
+        err = "arrival mode '" + cfg.mode + "' requires a finite REQUEST_RATE > 0";
+        return false;
+    }
+    double shape = cfg.mode == "poisson" ? 1.0 : cfg.burstiness;
+    if (cfg.mode == "gamma" && !(shape > 0.0)) {
+        err = "BURSTINESS must be > 0";
+        return false;
+    }
+
+    std::mt19937_64 rng(cfg.seed);
+    std::gamma_distribution<double> gamma(shape, 1.0 / (cfg.request_rate * shape));
+    double t = 0.0;
+    offsets.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        offsets.push_back(t);
+        t += cfg.mode == "constant" ? 1.0 / cfg.request_rate : gamma(rng);
+    }
+    return true;
+}
@@ -0,0 +1,145 @@
+// ============================================
+// Batch Manifest
+// ============================================
+// manifest.json in a batch directory records what the batch was asked to run
+// (model, mode, ISL/OSL/CONC matrix) and, per point, how it ended, a hash
+// of its result file and, once submitted, the leaderboard's event ID:
+//
+//   {"version":1,"model":...,"mode":"perf","created":"...",
+//    "isls":[8192],"osls":[1024],"concs":[4,32,128],
+//    "points":[{"isl":8192,"osl":1024,"conc":4,"status":"passed",
+//               "result_file":"result_isl8192_osl1024_conc4.json",
+//               "result_hash":"...","duration_s":612,"finished_at":"...",
+//               "event_id":"..."},...]}
+//
+// It is rewritten after every point (temporary file + rename), so a batch
+// killed mid-run still has the state of every point that finished. Resuming
+// keeps the passed points whose result file still matches its hash and
+// reruns the rest (pending, failed, skipped, or changed on disk). A resumed
+// submit only sends the points without an event ID.
+
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+
+static const int BATCH_MANIFEST_VERSION = 1;
+static const char* const BATCH_MANIFEST_FILE = "manifest.json";
+
+struct ManifestPoint {
+    int isl = 0;
+    int osl = 0;
+    int conc = 0;
+    std::string status = "pending";             // pending, passed, failed, skipped
+    std::string result_file;                    // relative to the batch directory
+    std::string result_hash;                    // of the result file, when passed
+    long long duration_s = 0;
+    std::string finished_at;
+    std::string event_id;                       // leaderboard submission, empty until accepted
+};
+
+struct BatchManifest {
+    std::string model;
+    std::string mode;
+    std::string created;
+    std::vector<std::string> resumed;           // times the batch was resumed
+    std::vector<int> isls;
+    std::vector<int> osls;
+    std::vector<int> concs;
+    std::vector<ManifestPoint> points;
+
+    ManifestPoint* find(int isl, int osl, int conc) {
+        for (ManifestPoint& p : points) {
+            if (p.isl == isl && p.osl == osl && p.conc == conc) return &p;
+        }
+        return nullptr;
+    }
+};
+
+inline bool write_batch_manifest(const std::string& path, const BatchManifest& m) {
+    auto int_array = [](const std::vector<int>& values) {
+        JsonValue a = JsonValue::array();
+        for (int v : values) a.push_back(v);
+        return a;
+    };
+    JsonValue doc = JsonValue::object();
+    doc.set("version", BATCH_MANIFEST_VERSION);
+    doc.set("model", m.model);
+    doc.set("mode", m.mode);
+    doc.set("created", m.created);
+    JsonValue resumed = JsonValue::array();
+    for (const std::string& t : m.resumed) resumed.push_back(t);
+    doc.set("resumed", resumed);
+    doc.set("isls", int_array(m.isls));
+    doc.set("osls", int_array(m.osls));
+    doc.set("concs", int_array(m.concs));
+    JsonValue points = JsonValue::array();
+    for (const ManifestPoint& p : m.points) {
+        JsonValue e = JsonValue::object();
+        e.set("isl", p.isl);
+        e.set("osl", p.osl);
+        e.set("conc", p.conc);
+        e.set("status", p.status);
+        e.set("result_file", p.result_file);
+        e.set("result_hash", p.result_hash);
+        e.set("duration_s", p.duration_s);
+        e.set("finished_at", p.finished_at);
+        e.set("event_id", p.event_id);
+        points.push_back(e);
+    }
+    doc.set("points", points);
+
+    std::string tmp = path + ".tmp";
+    std::ofstream out(tmp);
+    out << doc.dump(2) << "\n";
+    out.close();
+    if (!out) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+inline bool read_batch_manifest(const std::string& path, BatchManifest& m, std::string* error = nullptr) {
+    JsonValue doc;
+    if (!json_parse_file(path, doc, error)) return false;
+    if (doc["version"].as_int() != BATCH_MANIFEST_VERSION) {
+        if (error) *error = path + " is not a version " + std::to_string(BATCH_MANIFEST_VERSION) + " batch manifest";
+        return false;
+    }
+    auto int_list = [](const JsonValue& a) {
+        std::vector<int> values;
+        for (const JsonValue& v : a.items()) values.push_back(static_cast<int>(v.as_int()));
+        return values;
+    };
+    m = BatchManifest();
+    m.model = doc["model"].as_string();
+    m.mode = doc["mode"].as_string();
+    m.created = doc["created"].as_string();
+    for (const JsonValue& t : doc["resumed"].items()) m.resumed.push_back(t.as_string());
+    m.isls = int_list(doc["isls"]);
+    m.osls = int_list(doc["osls"]);
+    m.concs = int_list(doc["concs"]);
+    for (const JsonValue& e : doc["points"].items()) {
+        ManifestPoint p;
+        p.isl = static_cast<int>(e["isl"].as_int());
+        p.osl = static_cast<int>(e["osl"].as_int());
+        p.conc = static_cast<int>(e["conc"].as_int());
+        p.status = e["status"].as_string("pending");
+        p.result_file = e["result_file"].as_string();
+        p.result_hash = e["result_hash"].as_string();
+        p.duration_s = e["duration_s"].as_int();
+        p.finished_at = e["finished_at"].as_string();
+        p.event_id = e["event_id"].as_string();
+        m.points.push_back(p);
+    }
+    if (m.isls.empty() || m.osls.empty() || m.concs.empty()) {
+        if (error) *error = path + " has no ISL/OSL/CONC matrix";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+// ============================================
+// GPU Layout
+// ============================================
+// How many GPUs served the run, for per-GPU throughput. A deployment is
+// `instances` server replicas of `tp` GPUs each (expert parallelism reuses
+// the TP group's GPUs), e.g. TP=4 x 2 data-parallel replicas = 8 GPUs.
+//
+// NUM_GPUS overrides the product for layouts this cannot describe. The
+// devices exported in HIP_VISIBLE_DEVICES / ROCR_VISIBLE_DEVICES are only a
+// cross-check: they usually come from the server's launch shell, and GPUs
+// that are visible but unused do not count.
+
+#pragma once
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+struct GpuLayout {
+    int tp = 8;
+    int instances = 1;
+    int num_gpus = 8;                           // per-GPU throughput divides by this
+    int visible_devices = -1;                   // -1 = neither variable set
+    std::string visible_source;                 // which variable visible_devices came from
+    std::string source;                         // how num_gpus was determined
+    std::string warning;                        // non-empty when the sources disagree
+};
+
+// Counts the entries of a device list such as "0,1,2,3". -1 when unset.
+inline int count_visible_devices(const char* value) {
+    if (!value) return -1;
+    std::stringstream ss(value);
+    std::string item;
+    int n = 0;
+    while (std::getline(ss, item, ',')) {
+        if (item.find_first_not_of(" \t") != std::string::npos) n++;
+    }
+    return n;
+}
+
+inline GpuLayout resolve_gpu_layout(int tp, int instances, int num_gpus_override) {
+    GpuLayout g;
+    g.tp = tp > 0 ? tp : 1;
+    g.instances = instances > 0 ? instances : 1;
+    for (const char* var : {"HIP_VISIBLE_DEVICES", "ROCR_VISIBLE_DEVICES"}) {
+        int n = count_visible_devices(std::getenv(var));
+        if (n >= 0) {
+            g.visible_devices = n;
+            g.visible_source = var;
+            break;
+        }
+    }
+
+    int layout_gpus = g.tp * g.instances;
+    if (num_gpus_override > 0) {
+        g.num_gpus = num_gpus_override;
+        g.source = "NUM_GPUS";
+        if (num_gpus_override != layout_gpus) {
+            g.warning = "NUM_GPUS=" + std::to_string(num_gpus_override) + " differs from TP x instances = " +
+                        std::to_string(layout_gpus);
+        }
+    } else {
+        g.num_gpus = layout_gpus;
+        g.source = g.instances > 1 ? "TP x instances" : "TP";
+    }
+    if (g.warning.empty() && g.visible_devices >= 0 && g.visible_devices < g.num_gpus) {
+        g.warning = std::to_string(g.num_gpus) + " GPUs in the layout but only " +
+                    std::to_string(g.visible_devices) + " in " + g.visible_source;
+    }
+    return g;
+}
+
+inline std::string describe_gpu_layout(const GpuLayout& g) {
+    std::string s = std::to_string(g.num_gpus) + " (TP=" + std::to_string(g.tp);
+    if (g.instances > 1) s += " x " + std::to_string(g.instances) + " instances";
+    s += ", from " + g.source + ")";
+    return s;
+}
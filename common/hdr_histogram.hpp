@@ -0,0 +1,244 @@
+// ============================================
+// HDR Histogram
+// ============================================
+// High Dynamic Range histogram (after Gil Tene's HdrHistogram): records
+// values across a wide range with a fixed number of significant decimal
+// digits, in constant memory, and answers any percentile query. Two
+// histograms with the same configuration merge by adding their count arrays,
+// so per-thread or per-run histograms combine cheaply.
+//
+// Values are recorded as doubles and stored as integers after multiplying by
+// `scale`; with the default scale of 1000, millisecond latencies are kept at
+// microsecond resolution.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class HdrHistogram {
+public:
+    // lowest/highest are in scaled (integer) units; significant_digits in [1, 5].
+    HdrHistogram(int64_t lowest_discernible = 1, int64_t highest_trackable = 3600LL * 1000 * 1000,
+                 int significant_digits = 3, double scale = 1000.0)
+        : lowest_(std::max<int64_t>(1, lowest_discernible)),
+          highest_(std::max(highest_trackable, 2 * std::max<int64_t>(1, lowest_discernible))),
+          digits_(std::min(5, std::max(1, significant_digits))),
+          scale_(scale) {
+        int64_t largest_single_unit = 2 * static_cast<int64_t>(std::pow(10.0, digits_));
+        unit_magnitude_ = static_cast<int>(std::floor(std::log2(static_cast<double>(lowest_))));
+        sub_bucket_count_magnitude_ = static_cast<int>(std::ceil(std::log2(static_cast<double>(largest_single_unit))));
+        sub_bucket_half_count_magnitude_ = sub_bucket_count_magnitude_ - 1;
+        sub_bucket_count_ = 1 << sub_bucket_count_magnitude_;
+        sub_bucket_half_count_ = sub_bucket_count_ / 2;
+        sub_bucket_mask_ = static_cast<int64_t>(sub_bucket_count_ - 1) << unit_magnitude_;
+
+        int64_t smallest_untrackable = static_cast<int64_t>(sub_bucket_count_) << unit_magnitude_;
+        bucket_count_ = 1;
+        while (smallest_untrackable <= highest_) {
+            if (smallest_untrackable > INT64_MAX / 2) {
+                bucket_count_++;
+                break;
+            }
+            smallest_untrackable <<= 1;
+            bucket_count_++;
+        }
+        counts_.assign(static_cast<size_t>(bucket_count_ + 1) * sub_bucket_half_count_, 0);
+    }
+
+    // Records one sample (in unscaled units, e.g. ms). Out-of-range values are
+    // clamped to the trackable range rather than dropped.
+    void record(double value, int64_t count = 1) {
+        int64_t v = static_cast<int64_t>(std::llround(value * scale_));
+        record_value(v, count);
+    }
+
+    void record_value(int64_t v, int64_t count = 1) {
+        v = std::min(std::max<int64_t>(v, 0), highest_);
+        counts_[counts_index_for(v)] += count;
+        total_count_ += count;
+        sum_ += static_cast<double>(v) * count;
+        if (total_count_ == count || v < min_) min_ = v;
+        if (v > max_) max_ = v;
+    }
+
+    // Adds `other` into this histogram. Identical layouts add count arrays;
+    // otherwise each of other's buckets is re-recorded at its median value.
+    void merge(const HdrHistogram& other) {
+        if (other.total_count_ == 0) return;
+        if (same_layout(other)) {
+            for (size_t i = 0; i < counts_.size(); i++) counts_[i] += other.counts_[i];
+            if (total_count_ == 0 || other.min_ < min_) min_ = other.min_;
+            max_ = std::max(max_, other.max_);
+            total_count_ += other.total_count_;
+            sum_ += other.sum_;
+            return;
+        }
+        for (size_t i = 0; i < other.counts_.size(); i++) {
+            if (other.counts_[i] == 0) continue;
+            record_value(other.median_equivalent(other.value_from_index(static_cast<int>(i))), other.counts_[i]);
+        }
+    }
+
+    void reset() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_count_ = 0;
+        sum_ = 0.0;
+        min_ = 0;
+        max_ = 0;
+    }
+
+    int64_t count() const { return total_count_; }
+    double mean() const { return total_count_ ? sum_ / total_count_ / scale_ : 0.0; }
+    double min() const { return total_count_ ? min_ / scale_ : 0.0; }
+    double max() const { return total_count_ ? max_ / scale_ : 0.0; }
+
+    // Smallest recorded value v such that `percentile`% of samples are <= v,
+    // reported as the highest value equivalent to v at this precision.
+    double value_at_percentile(double percentile) const {
+        if (total_count_ == 0) return 0.0;
+        if (percentile >= 100.0) return max();
+        double p = std::max(0.0, percentile);
+        int64_t count_at = static_cast<int64_t>(std::ceil(p / 100.0 * total_count_));
+        count_at = std::max<int64_t>(1, count_at);
+        int64_t running = 0;
+        for (size_t i = 0; i < counts_.size(); i++) {
+            running += counts_[i];
+            if (running >= count_at) {
+                int64_t v = highest_equivalent(value_from_index(static_cast<int>(i)));
+                return std::min(v, max_) / scale_;
+            }
+        }
+        return max();
+    }
+
+    size_t memory_bytes() const { return counts_.size() * sizeof(int64_t); }
+
+    // Compact sparse text form "digits lowest highest scale|index:count,..."
+    // for storing next to a result and merging across runs later.
+    std::string encode() const {
+        std::stringstream ss;
+        ss << digits_ << " " << lowest_ << " " << highest_ << " " << scale_ << "|";
+        bool first = true;
+        for (size_t i = 0; i < counts_.size(); i++) {
+            if (counts_[i] == 0) continue;
+            ss << (first ? "" : ",") << i << ":" << counts_[i];
+            first = false;
+        }
+        return ss.str();
+    }
+
+    static bool decode(const std::string& text, HdrHistogram& out) {
+        size_t bar = text.find('|');
+        if (bar == std::string::npos) return false;
+        std::stringstream header(text.substr(0, bar));
+        int digits;
+        int64_t lowest, highest;
+        double scale;
+        if (!(header >> digits >> lowest >> highest >> scale)) return false;
+        out = HdrHistogram(lowest, highest, digits, scale);
+        std::stringstream body(text.substr(bar + 1));
+        std::string entry;
+        while (std::getline(body, entry, ',')) {
+            size_t colon = entry.find(':');
+            if (colon == std::string::npos) return false;
+            size_t index = std::stoull(entry.substr(0, colon));
+            int64_t count = std::stoll(entry.substr(colon + 1));
+            if (index >= out.counts_.size()) return false;
+            out.record_value(out.median_equivalent(out.value_from_index(static_cast<int>(index))), count);
+        }
+        return true;
+    }
+
+private:
+    bool same_layout(const HdrHistogram& o) const {
+        return lowest_ == o.lowest_ && highest_ == o.highest_ && digits_ == o.digits_ && scale_ == o.scale_;
+    }
+
+    int bucket_index_for(int64_t v) const {
+        int pow2ceiling = 64 - __builtin_clzll(static_cast<uint64_t>(v | sub_bucket_mask_));
+        return pow2ceiling - unit_magnitude_ - (sub_bucket_half_count_magnitude_ + 1);
+    }
+
+    size_t counts_index_for(int64_t v) const {
+        int bucket_index = bucket_index_for(v);
+        int sub_bucket_index = static_cast<int>(v >> (bucket_index + unit_magnitude_));
+        int bucket_base = (bucket_index + 1) << sub_bucket_half_count_magnitude_;
+        return static_cast<size_t>(bucket_base + (sub_bucket_index - sub_bucket_half_count_));
+    }
+
+    int64_t value_from_index(int index) const {
+        int bucket_index = (index >> sub_bucket_half_count_magnitude_) - 1;
+        int sub_bucket_index = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+        if (bucket_index < 0) {
+            sub_bucket_index -= sub_bucket_half_count_;
+            bucket_index = 0;
+        }
+        return static_cast<int64_t>(sub_bucket_index) << (bucket_index + unit_magnitude_);
+    }
+
+    int64_t size_of_equivalent_range(int64_t v) const {
+        int bucket_index = bucket_index_for(v);
+        int sub_bucket_index = static_cast<int>(v >> (bucket_index + unit_magnitude_));
+        int adjusted = sub_bucket_index >= sub_bucket_count_ ? bucket_index + 1 : bucket_index;
+        return int64_t(1) << (unit_magnitude_ + adjusted);
+    }
+
+    int64_t lowest_equivalent(int64_t v) const {
+        int bucket_index = bucket_index_for(v);
+        int sub_bucket_index = static_cast<int>(v >> (bucket_index + unit_magnitude_));
+        return static_cast<int64_t>(sub_bucket_index) << (bucket_index + unit_magnitude_);
+    }
+
+    int64_t highest_equivalent(int64_t v) const {
+        return lowest_equivalent(v) + size_of_equivalent_range(v) - 1;
+    }
+
+    int64_t median_equivalent(int64_t v) const {
+        return lowest_equivalent(v) + size_of_equivalent_range(v) / 2;
+    }
+
+    int64_t lowest_;
+    int64_t highest_;
+    int digits_;
+    double scale_;
+    int unit_magnitude_ = 0;
+    int sub_bucket_count_magnitude_ = 0;
+    int sub_bucket_half_count_magnitude_ = 0;
+    int sub_bucket_count_ = 0;
+    int sub_bucket_half_count_ = 0;
+    int64_t sub_bucket_mask_ = 0;
+    int bucket_count_ = 0;
+    std::vector<int64_t> counts_;
+    int64_t total_count_ = 0;
+    double sum_ = 0.0;
+    int64_t min_ = 0;
+    int64_t max_ = 0;
+};
+
+// Percentile set reported for every latency metric.
+struct PercentileSet {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+inline PercentileSet percentile_set(const HdrHistogram& h) {
+    PercentileSet s;
+    s.mean = h.mean();
+    s.p50 = h.value_at_percentile(50.0);
+    s.p90 = h.value_at_percentile(90.0);
+    s.p95 = h.value_at_percentile(95.0);
+    s.p99 = h.value_at_percentile(99.0);
+    s.p999 = h.value_at_percentile(99.9);
+    s.max = h.max();
+    return s;
+}
@@ -0,0 +1,602 @@
+// ============================================
+// JSON Parser (SAX + DOM)
+// ============================================
+// Header-only JSON reader shared by the track binaries.
+//
+//   - json_sax_parse(text, handler) walks a document and calls the handler
+//     for every value without allocating: strings and keys are handed over as
+//     views of the raw (still escaped) text. This is what the load generator
+//     uses on every streamed SSE chunk.
+//   - json_parse(text, value) / json_parse_file(path, value) build a
+//     JsonValue tree on top of the SAX parser, for result files, baselines
+//     and server responses with nested objects and arrays.
+//
+// The scan for the end of a string (the bulk of the bytes in SSE chunks and
+// result files) runs 16 bytes at a time with SSE2 where available. Numbers
+// are converted with std::from_chars. The parser accepts RFC 8259 JSON and is
+// lenient only about raw control characters inside strings.
+
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ============================================
+// Scanning Primitives
+// ============================================
+namespace json_detail {
+
+inline bool is_ws(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+inline const char* skip_ws(const char* p, const char* end) {
+    while (p < end && is_ws(*p)) p++;
+    return p;
+}
+
+// First '"' or '\\' in [p, end), or end.
+inline const char* scan_string(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)));
+        if (mask) return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\') p++;
+    return p;
+}
+
+inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+inline bool read_hex4(const char* p, const char* end, uint32_t& out) {
+    if (end - p < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; i++) {
+        int h = hex_value(p[i]);
+        if (h < 0) return false;
+        out = (out << 4) | static_cast<uint32_t>(h);
+    }
+    return true;
+}
+
+inline void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+}  // namespace json_detail
+
+// Decodes the raw contents of a JSON string (between the quotes) into UTF-8.
+inline bool json_unescape(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    const char* p = raw.data();
+    const char* end = p + raw.size();
+    while (p < end) {
+        const char* run = json_detail::scan_string(p, end);
+        out.append(p, run);
+        p = run;
+        if (p >= end) break;
+        if (*p != '\\' || ++p >= end) return false;
+        switch (*p++) {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!json_detail::read_hex4(p, end, cp)) return false;
+                p += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    uint32_t lo;
+                    if (json_detail::read_hex4(p + 2, end, lo) && lo >= 0xDC00 && lo <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        p += 6;
+                    }
+                }
+                json_detail::append_utf8(out, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+inline std::string json_escape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+// ============================================
+// SAX Parser
+// ============================================
+// Derive from JsonSaxHandler and hide the callbacks you need; the parser is
+// a template over the handler type, so there is no virtual dispatch. Every
+// callback returns false to abort the parse. `raw` strings are the bytes
+// between the quotes; `escaped` says whether json_unescape() is needed.
+struct JsonSaxHandler {
+    bool on_null() { return true; }
+    bool on_bool(bool) { return true; }
+    bool on_integer(long long) { return true; }
+    bool on_double(double) { return true; }
+    bool on_string(std::string_view /*raw*/, bool /*escaped*/) { return true; }
+    bool on_key(std::string_view /*raw*/, bool /*escaped*/) { return true; }
+    bool start_object() { return true; }
+    bool end_object() { return true; }
+    bool start_array() { return true; }
+    bool end_array() { return true; }
+};
+
+static const int JSON_MAX_DEPTH = 512;
+
+template <typename Handler>
+class JsonSaxParser {
+public:
+    JsonSaxParser(std::string_view text, Handler& handler)
+        : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()), h_(handler) {}
+
+    // Parses exactly one document (surrounding whitespace allowed).
+    bool parse() {
+        p_ = json_detail::skip_ws(p_, end_);
+        if (!parse_value(0)) return false;
+        p_ = json_detail::skip_ws(p_, end_);
+        if (p_ != end_) return fail("trailing characters after document");
+        return true;
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool fail(const char* what) {
+        if (error_.empty()) error_ = std::string(what) + " at offset " + std::to_string(p_ - begin_);
+        return false;
+    }
+
+    bool literal(const char* word, size_t len) {
+        if (static_cast<size_t>(end_ - p_) < len || std::string_view(p_, len) != std::string_view(word, len)) {
+            return fail("invalid literal");
+        }
+        p_ += len;
+        return true;
+    }
+
+    bool parse_string(std::string_view& raw, bool& escaped) {
+        const char* start = ++p_;               // past the opening quote
+        escaped = false;
+        while (true) {
+            p_ = json_detail::scan_string(p_, end_);
+            if (p_ >= end_) return fail("unterminated string");
+            if (*p_ == '"') break;
+            escaped = true;
+            p_ += 2;                            // backslash and the escaped char
+        }
+        raw = std::string_view(start, p_ - start);
+        p_++;
+        return true;
+    }
+
+    bool parse_number() {
+        const char* start = p_;
+        bool integral = true;
+        if (p_ < end_ && *p_ == '-') p_++;
+        while (p_ < end_) {
+            char c = *p_;
+            if (c >= '0' && c <= '9') {
+                p_++;
+            } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                integral = false;
+                p_++;
+            } else {
+                break;
+            }
+        }
+        if (integral) {
+            long long v;
+            auto r = std::from_chars(start, p_, v);
+            if (r.ec == std::errc() && r.ptr == p_) return h_.on_integer(v) || fail("aborted by handler");
+        }
+        double d;
+        auto r = std::from_chars(start, p_, d);
+        if (r.ec != std::errc() || r.ptr != p_) return fail("invalid number");
+        return h_.on_double(d) || fail("aborted by handler");
+    }
+
+    bool parse_value(int depth) {
+        if (p_ >= end_) return fail("unexpected end of input");
+        if (depth > JSON_MAX_DEPTH) return fail("nesting too deep");
+        switch (*p_) {
+            case '{': {
+                p_++;
+                if (!h_.start_object()) return fail("aborted by handler");
+                p_ = json_detail::skip_ws(p_, end_);
+                if (p_ < end_ && *p_ == '}') {
+                    p_++;
+                    return h_.end_object() || fail("aborted by handler");
+                }
+                while (true) {
+                    if (p_ >= end_ || *p_ != '"') return fail("expected object key");
+                    std::string_view key;
+                    bool escaped;
+                    if (!parse_string(key, escaped)) return false;
+                    if (!h_.on_key(key, escaped)) return fail("aborted by handler");
+                    p_ = json_detail::skip_ws(p_, end_);
+                    if (p_ >= end_ || *p_ != ':') return fail("expected ':'");
+                    p_ = json_detail::skip_ws(p_ + 1, end_);
+                    if (!parse_value(depth + 1)) return false;
+                    p_ = json_detail::skip_ws(p_, end_);
+                    if (p_ < end_ && *p_ == ',') {
+                        p_ = json_detail::skip_ws(p_ + 1, end_);
+                        continue;
+                    }
+                    if (p_ < end_ && *p_ == '}') {
+                        p_++;
+                        return h_.end_object() || fail("aborted by handler");
+                    }
+                    return fail("expected ',' or '}'");
+                }
+            }
+            case '[': {
+                p_++;
+                if (!h_.start_array()) return fail("aborted by handler");
+                p_ = json_detail::skip_ws(p_, end_);
+                if (p_ < end_ && *p_ == ']') {
+                    p_++;
+                    return h_.end_array() || fail("aborted by handler");
+                }
+                while (true) {
+                    if (!parse_value(depth + 1)) return false;
+                    p_ = json_detail::skip_ws(p_, end_);
+                    if (p_ < end_ && *p_ == ',') {
+                        p_ = json_detail::skip_ws(p_ + 1, end_);
+                        continue;
+                    }
+                    if (p_ < end_ && *p_ == ']') {
+                        p_++;
+                        return h_.end_array() || fail("aborted by handler");
+                    }
+                    return fail("expected ',' or ']'");
+                }
+            }
+            case '"': {
+                std::string_view raw;
+                bool escaped;
+                if (!parse_string(raw, escaped)) return false;
+                return h_.on_string(raw, escaped) || fail("aborted by handler");
+            }
+            case 't':
+                return literal("true", 4) && (h_.on_bool(true) || fail("aborted by handler"));
+            case 'f':
+                return literal("false", 5) && (h_.on_bool(false) || fail("aborted by handler"));
+            case 'n':
+                return literal("null", 4) && (h_.on_null() || fail("aborted by handler"));
+            default:
+                if (*p_ == '-' || (*p_ >= '0' && *p_ <= '9')) return parse_number();
+                return fail("unexpected character");
+        }
+    }
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    Handler& h_;
+    std::string error_;
+};
+
+template <typename Handler>
+inline bool json_sax_parse(std::string_view text, Handler& handler, std::string* error = nullptr) {
+    JsonSaxParser<Handler> parser(text, handler);
+    bool ok = parser.parse();
+    if (!ok && error) *error = parser.error();
+    return ok;
+}
+
+// ============================================
+// DOM
+// ============================================
+class JsonValue {
+public:
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;  // document order
+
+    enum Type { NUL, BOOL, INTEGER, DOUBLE, STRING, ARRAY, OBJECT };
+
+    JsonValue() = default;
+    JsonValue(std::nullptr_t) {}
+    JsonValue(bool b) : v_(b) {}
+    JsonValue(int i) : v_(static_cast<long long>(i)) {}
+    JsonValue(long long i) : v_(i) {}
+    JsonValue(size_t i) : v_(static_cast<long long>(i)) {}
+    JsonValue(double d) : v_(d) {}
+    JsonValue(const char* s) : v_(std::string(s)) {}
+    JsonValue(std::string s) : v_(std::move(s)) {}
+
+    static JsonValue array() { JsonValue v; v.v_ = Array(); return v; }
+    static JsonValue object() { JsonValue v; v.v_ = Object(); return v; }
+
+    Type type() const { return static_cast<Type>(v_.index()); }
+    bool is_null() const { return type() == NUL; }
+    bool is_bool() const { return type() == BOOL; }
+    bool is_number() const { return type() == INTEGER || type() == DOUBLE; }
+    bool is_string() const { return type() == STRING; }
+    bool is_array() const { return type() == ARRAY; }
+    bool is_object() const { return type() == OBJECT; }
+
+    bool as_bool(bool fallback = false) const { return is_bool() ? std::get<bool>(v_) : fallback; }
+    double as_double(double fallback = 0.0) const {
+        if (type() == DOUBLE) return std::get<double>(v_);
+        if (type() == INTEGER) return static_cast<double>(std::get<long long>(v_));
+        return fallback;
+    }
+    long long as_int(long long fallback = 0) const {
+        if (type() == INTEGER) return std::get<long long>(v_);
+        if (type() == DOUBLE) return static_cast<long long>(std::get<double>(v_));
+        return fallback;
+    }
+    std::string as_string(const std::string& fallback = "") const {
+        return is_string() ? std::get<std::string>(v_) : fallback;
+    }
+
+    // Array elements or object members; 0 for scalars.
+    size_t size() const {
+        if (is_array()) return std::get<Array>(v_).size();
+        if (is_object()) return std::get<Object>(v_).size();
+        return 0;
+    }
+
+    // Missing keys, out-of-range indices and type mismatches yield null, so
+    // lookups chain: doc["baseline"]["tput_per_gpu"].as_double().
+    const JsonValue& operator[](size_t i) const {
+        if (!is_array() || i >= std::get<Array>(v_).size()) return null_value();
+        return std::get<Array>(v_)[i];
+    }
+    const JsonValue& operator[](std::string_view key) const {
+        const JsonValue* v = find(key);
+        return v ? *v : null_value();
+    }
+    const JsonValue* find(std::string_view key) const {
+        if (!is_object()) return nullptr;
+        for (const auto& m : std::get<Object>(v_)) {
+            if (m.first == key) return &m.second;
+        }
+        return nullptr;
+    }
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    const Array& items() const { return is_array() ? std::get<Array>(v_) : empty_array(); }
+    const Object& members() const { return is_object() ? std::get<Object>(v_) : empty_object(); }
+
+    // Mutation, for building documents to write out.
+    JsonValue& push_back(JsonValue v) {
+        if (!is_array()) v_ = Array();
+        Array& a = std::get<Array>(v_);
+        a.push_back(std::move(v));
+        return a.back();
+    }
+    JsonValue& set(std::string_view key, JsonValue v) {
+        if (!is_object()) v_ = Object();
+        Object& o = std::get<Object>(v_);
+        for (auto& m : o) {
+            if (m.first == key) {
+                m.second = std::move(v);
+                return m.second;
+            }
+        }
+        o.emplace_back(std::string(key), std::move(v));
+        return o.back().second;
+    }
+    bool erase(std::string_view key) {
+        if (!is_object()) return false;
+        Object& o = std::get<Object>(v_);
+        for (auto it = o.begin(); it != o.end(); ++it) {
+            if (it->first == key) {
+                o.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Serialises like Python's json.dumps: indent < 0 is compact, otherwise
+    // one member per line; doubles always carry a '.' or exponent.
+    std::string dump(int indent = -1) const {
+        std::string out;
+        dump_to(out, indent, 0);
+        return out;
+    }
+
+private:
+    static const JsonValue& null_value() {
+        static const JsonValue v;
+        return v;
+    }
+    static const Array& empty_array() {
+        static const Array a;
+        return a;
+    }
+    static const Object& empty_object() {
+        static const Object o;
+        return o;
+    }
+
+    static void newline(std::string& out, int indent, int level) {
+        if (indent < 0) return;
+        out += '\n';
+        out.append(static_cast<size_t>(indent) * level, ' ');
+    }
+
+    void dump_to(std::string& out, int indent, int level) const {
+        switch (type()) {
+            case NUL: out += "null"; break;
+            case BOOL: out += std::get<bool>(v_) ? "true" : "false"; break;
+            case INTEGER: out += std::to_string(std::get<long long>(v_)); break;
+            case DOUBLE: {
+                double d = std::get<double>(v_);
+                if (d != d || d - d != 0) {             // NaN / inf are not JSON; json_parse rejects them bare
+                    out += "null";
+                    break;
+                }
+                char buf[32];
+                auto r = std::to_chars(buf, buf + sizeof(buf), d);
+                std::string_view s(buf, r.ptr - buf);
+                out += s;
+                if (s.find_first_of(".eE") == std::string_view::npos) out += ".0";
+                break;
+            }
+            case STRING: out += '"'; out += json_escape(std::get<std::string>(v_)); out += '"'; break;
+            case ARRAY: {
+                const Array& a = std::get<Array>(v_);
+                out += '[';
+                for (size_t i = 0; i < a.size(); i++) {
+                    if (i) out += indent < 0 ? ", " : ",";
+                    newline(out, indent, level + 1);
+                    a[i].dump_to(out, indent, level + 1);
+                }
+                if (!a.empty()) newline(out, indent, level);
+                out += ']';
+                break;
+            }
+            case OBJECT: {
+                const Object& o = std::get<Object>(v_);
+                out += '{';
+                for (size_t i = 0; i < o.size(); i++) {
+                    if (i) out += indent < 0 ? ", " : ",";
+                    newline(out, indent, level + 1);
+                    out += '"';
+                    out += json_escape(o[i].first);
+                    out += "\": ";
+                    o[i].second.dump_to(out, indent, level + 1);
+                }
+                if (!o.empty()) newline(out, indent, level);
+                out += '}';
+                break;
+            }
+        }
+    }
+
+    std::variant<std::monostate, bool, long long, double, std::string, Array, Object> v_;
+};
+
+// Builds a JsonValue tree from SAX events.
+class JsonDomBuilder : public JsonSaxHandler {
+public:
+    explicit JsonDomBuilder(JsonValue& root) : root_(root) {}
+
+    bool on_null() { add(JsonValue()); return true; }
+    bool on_bool(bool b) { add(JsonValue(b)); return true; }
+    bool on_integer(long long i) { add(JsonValue(i)); return true; }
+    bool on_double(double d) { add(JsonValue(d)); return true; }
+    bool on_string(std::string_view raw, bool escaped) {
+        if (!escaped) {
+            add(JsonValue(std::string(raw)));
+            return true;
+        }
+        std::string s;
+        if (!json_unescape(raw, s)) return false;
+        add(JsonValue(std::move(s)));
+        return true;
+    }
+    bool on_key(std::string_view raw, bool escaped) {
+        if (!escaped) {
+            key_.assign(raw.data(), raw.size());
+            return true;
+        }
+        return json_unescape(raw, key_);
+    }
+    bool start_object() { stack_.push_back(&add(JsonValue::object())); return true; }
+    bool end_object() { stack_.pop_back(); return true; }
+    bool start_array() { stack_.push_back(&add(JsonValue::array())); return true; }
+    bool end_array() { stack_.pop_back(); return true; }
+
+private:
+    // Only the innermost open container is ever appended to, so the pointers
+    // held for its ancestors stay valid.
+    JsonValue& add(JsonValue v) {
+        if (stack_.empty()) {
+            root_ = std::move(v);
+            return root_;
+        }
+        JsonValue& top = *stack_.back();
+        if (top.is_array()) return top.push_back(std::move(v));
+        return top.set(key_, std::move(v));
+    }
+
+    JsonValue& root_;
+    std::vector<JsonValue*> stack_;
+    std::string key_;
+};
+
+inline bool json_parse(std::string_view text, JsonValue& out, std::string* error = nullptr) {
+    out = JsonValue();
+    JsonDomBuilder builder(out);
+    return json_sax_parse(text, builder, error);
+}
+
+inline bool json_parse_file(const std::string& path, JsonValue& out, std::string* error = nullptr) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return json_parse(text, out, error);
+}
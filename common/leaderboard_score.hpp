@@ -0,0 +1,181 @@
+// ============================================
+// Leaderboard Scoring Simulator
+// ============================================
+// The README ranking rules applied offline to any set of entries (our
+// batches, historical runs, competitor snapshots):
+//
+//   1. dominance in the performance curve: an entry's curve dominates
+//      another's when every point of the other (throughput per GPU up,
+//      interactivity up, E2E down), at whatever CONC, is matched or beaten by
+//      some point of it, and not the other way round. Entries are ranked by
+//      non-dominated curve layer first, at every CONC;
+//   2. where curves intersect, at each CONC the points are ranked by
+//      non-dominated layer (a point nobody beats on all three places above
+//      every point it beats), then by the tie-breaker: 50% throughput per
+//      GPU, 30% interactivity, 20% E2E, each normalised to the best entry at
+//      that CONC;
+//   3. points: 1st place 1000, 2nd 900, ... per CONC, summed over the CONC
+//      set. An entry missing a CONC scores nothing there, which is the
+//      consistency rule.
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ScorePoint {
+    double tput_per_gpu = 0.0;
+    double interactivity = 0.0;
+    double median_e2e_ms = 0.0;
+};
+
+struct ScoreEntry {
+    std::string name;
+    std::map<int, ScorePoint> points;           // by CONC
+};
+
+struct ScorePlacing {
+    bool present = false;
+    int layer = 0;                              // 0 = not dominated by any other entry
+    double weighted = 0.0;                      // tie-breaker score in [0, 1]
+    int place = 0;                              // 1-based
+    int points = 0;
+};
+
+struct ScoreStanding {
+    std::string name;
+    int curve_layer = 0;                        // 0 = no other entry's curve dominates this one
+    std::map<int, ScorePlacing> placings;       // by CONC
+    int total = 0;
+    double weighted_sum = 0.0;
+};
+
+static const int SCORE_FIRST_PLACE_POINTS = 1000;
+static const int SCORE_PLACE_STEP = 100;
+static const double SCORE_WEIGHT_TPUT = 0.5;
+static const double SCORE_WEIGHT_INTERACTIVITY = 0.3;
+static const double SCORE_WEIGHT_E2E = 0.2;
+
+inline bool score_no_worse(const ScorePoint& a, const ScorePoint& b) {
+    return a.tput_per_gpu >= b.tput_per_gpu && a.interactivity >= b.interactivity &&
+           a.median_e2e_ms <= b.median_e2e_ms;
+}
+
+inline bool score_dominates(const ScorePoint& a, const ScorePoint& b) {
+    bool better = a.tput_per_gpu > b.tput_per_gpu || a.interactivity > b.interactivity ||
+                  a.median_e2e_ms < b.median_e2e_ms;
+    return score_no_worse(a, b) && better;
+}
+
+// Every point of `b` in the CONC set is matched or beaten by some point of
+// `a`: b's curve lies on or under a's.
+inline bool score_curve_covers(const ScoreEntry& a, const ScoreEntry& b, const std::vector<int>& concs) {
+    bool any = false;
+    for (int cb : concs) {
+        auto pb = b.points.find(cb);
+        if (pb == b.points.end()) continue;
+        any = true;
+        bool covered = false;
+        for (int ca : concs) {
+            auto pa = a.points.find(ca);
+            covered = covered || (pa != a.points.end() && score_no_worse(pa->second, pb->second));
+        }
+        if (!covered) return false;
+    }
+    return any;
+}
+
+// Strict: two entries with the same frontier cover each other and neither
+// dominates, so curve layers are always well defined.
+inline bool score_curve_dominates(const ScoreEntry& a, const ScoreEntry& b, const std::vector<int>& concs) {
+    return score_curve_covers(a, b, concs) && !score_curve_covers(b, a, concs);
+}
+
+inline int score_points_for_place(int place) {
+    return std::max(0, SCORE_FIRST_PLACE_POINTS - SCORE_PLACE_STEP * (place - 1));
+}
+
+// Standings sorted best first.
+inline std::vector<ScoreStanding> score_entries(const std::vector<ScoreEntry>& entries, const std::vector<int>& concs) {
+    std::vector<ScoreStanding> standings(entries.size());
+    for (size_t e = 0; e < entries.size(); e++) standings[e].name = entries[e].name;
+
+    std::vector<size_t> remaining;
+    for (size_t e = 0; e < entries.size(); e++) remaining.push_back(e);
+    for (int layer = 0; !remaining.empty(); layer++) {
+        std::vector<size_t> front, rest;
+        for (size_t a : remaining) {
+            bool dominated = false;
+            for (size_t b : remaining) {
+                dominated = dominated || (b != a && score_curve_dominates(entries[b], entries[a], concs));
+            }
+            (dominated ? rest : front).push_back(a);
+        }
+        for (size_t a : front) standings[a].curve_layer = layer;
+        remaining.swap(rest);
+    }
+
+    for (int conc : concs) {
+        std::vector<size_t> present;
+        for (size_t e = 0; e < entries.size(); e++) {
+            if (entries[e].points.count(conc)) present.push_back(e);
+        }
+        if (present.empty()) continue;
+        auto point = [&](size_t e) -> const ScorePoint& { return entries[e].points.at(conc); };
+
+        // Non-dominated sorting: peel off the undominated points layer by layer.
+        std::vector<size_t> remaining = present;
+        for (int layer = 0; !remaining.empty(); layer++) {
+            std::vector<size_t> front, rest;
+            for (size_t a : remaining) {
+                bool dominated = false;
+                for (size_t b : remaining) dominated = dominated || (b != a && score_dominates(point(b), point(a)));
+                (dominated ? rest : front).push_back(a);
+            }
+            for (size_t a : front) standings[a].placings[conc].layer = layer;
+            remaining.swap(rest);
+        }
+
+        double best_tput = 0, best_intvty = 0, best_e2e = 0;
+        for (size_t e : present) {
+            best_tput = std::max(best_tput, point(e).tput_per_gpu);
+            best_intvty = std::max(best_intvty, point(e).interactivity);
+            if (point(e).median_e2e_ms > 0 && (best_e2e == 0 || point(e).median_e2e_ms < best_e2e)) {
+                best_e2e = point(e).median_e2e_ms;
+            }
+        }
+        for (size_t e : present) {
+            const ScorePoint& p = point(e);
+            ScorePlacing& pl = standings[e].placings[conc];
+            pl.present = true;
+            pl.weighted = (best_tput > 0 ? SCORE_WEIGHT_TPUT * p.tput_per_gpu / best_tput : 0) +
+                          (best_intvty > 0 ? SCORE_WEIGHT_INTERACTIVITY * p.interactivity / best_intvty : 0) +
+                          (p.median_e2e_ms > 0 ? SCORE_WEIGHT_E2E * best_e2e / p.median_e2e_ms : 0);
+        }
+
+        std::stable_sort(present.begin(), present.end(), [&](size_t a, size_t b) {
+            if (standings[a].curve_layer != standings[b].curve_layer) {
+                return standings[a].curve_layer < standings[b].curve_layer;
+            }
+            const ScorePlacing& pa = standings[a].placings[conc];
+            const ScorePlacing& pb = standings[b].placings[conc];
+            if (pa.layer != pb.layer) return pa.layer < pb.layer;
+            return pa.weighted > pb.weighted;
+        });
+        for (size_t i = 0; i < present.size(); i++) {
+            ScorePlacing& pl = standings[present[i]].placings[conc];
+            pl.place = static_cast<int>(i) + 1;
+            pl.points = score_points_for_place(pl.place);
+            standings[present[i]].total += pl.points;
+            standings[present[i]].weighted_sum += pl.weighted;
+        }
+    }
+
+    std::stable_sort(standings.begin(), standings.end(), [](const ScoreStanding& a, const ScoreStanding& b) {
+        if (a.total != b.total) return a.total > b.total;
+        return a.weighted_sum > b.weighted_sum;
+    });
+    return standings;
+}
@@ -0,0 +1,556 @@
+// ============================================
+// Native Load Generator (replaces benchmark_serving.py)
+// ============================================
+// Header-only, shared by every track binary. Issues the same workload the
+// harness used to get from `benchmark_serving.py --dataset-name random
+// --ignore-eos --request-rate inf --max-concurrency CONC`, streams the
+// responses through libcurl and builds the run summary
+// (benchmark_summary_json) that process_result_json() writes.
+//
+// Only depends on libcurl, which every track binary already links (-lcurl).
+
+#pragma once
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arrival.hpp"
+#include "hdr_histogram.hpp"
+#include "json.hpp"
+#include "request_columns.hpp"
+#include "sharded_client.hpp"
+#include "steady_state.hpp"
+#include "trace_export.hpp"
+#include "workload.hpp"
+
+// ============================================
+// Summary Results
+// ============================================
+struct BenchmarkResult {
+    int completed = 0;
+    int failed = 0;
+    double duration_s = 0.0;
+    ArrivalConfig arrival;
+    std::string prompt_format = "text";
+    long long total_input = 0;
+    long long total_output = 0;
+
+    double request_throughput = 0.0;
+    double output_throughput = 0.0;
+    double total_token_throughput = 0.0;
+
+    double mean_ttft_ms = 0.0, median_ttft_ms = 0.0, p99_ttft_ms = 0.0;
+    double mean_tpot_ms = 0.0, median_tpot_ms = 0.0, p99_tpot_ms = 0.0;
+    double mean_itl_ms = 0.0, median_itl_ms = 0.0, p99_itl_ms = 0.0;
+    double mean_e2el_ms = 0.0, median_e2el_ms = 0.0, p99_e2el_ms = 0.0;
+
+    // Both definitions are reported for open-loop arrivals; latency_definition
+    // says which one the headline ttft/e2el fields above carry. The closed
+    // loop has no intended send times, so only service latency exists there.
+    std::string latency_definition = "service";
+    double mean_ttft_service_ms = 0.0, median_ttft_service_ms = 0.0, p99_ttft_service_ms = 0.0;
+    double mean_e2el_service_ms = 0.0, median_e2el_service_ms = 0.0, p99_e2el_service_ms = 0.0;
+    double mean_ttft_intended_ms = 0.0, median_ttft_intended_ms = 0.0, p99_ttft_intended_ms = 0.0;
+    double mean_e2el_intended_ms = 0.0, median_e2el_intended_ms = 0.0, p99_e2el_intended_ms = 0.0;
+    double mean_send_lag_ms = 0.0, p99_send_lag_ms = 0.0, max_send_lag_ms = 0.0;
+
+    // Extended percentiles from the HDR histograms (service latency). ITL
+    // headline fields above also come from here; per-request TTFT/TPOT/E2EL
+    // headline medians stay exact for parity with the leaderboard reference.
+    HdrHistogram ttft_hist, tpot_hist, itl_hist, e2el_hist;
+    PercentileSet ttft_pct, tpot_pct, itl_pct, e2el_pct;
+
+    // Keep-alive connection pool statistics for the measured run.
+    long long connections_opened = 0;
+    double connection_reuse_ratio = 0.0;
+    PercentileSet connect_pct;
+
+    // Client-side load: if a worker thread is close to 100% busy, the measured
+    // throughput may be client-bound rather than server-bound.
+    ClientUtilisation client;
+
+    // Metrics over the steady window (ramp-up and drain tail excluded). The
+    // headline fields above always cover the full run.
+    SteadyStateSummary steady;
+
+    // Adaptive sample size: the rule, the prompt cap and the last convergence
+    // check (adaptive_sampling.hpp).
+    AdaptiveSampling adaptive;
+    int max_prompts = 0;
+    ConvergenceState convergence;
+
+    std::vector<RequestResult> requests;
+};
+
+// ============================================
+// Metric Computation
+// ============================================
+inline void compute_benchmark_metrics(BenchmarkResult& res, int significant_digits = 3) {
+    HdrHistogram proto(1, 3600LL * 1000 * 1000, significant_digits);
+    res.ttft_hist = proto;
+    res.tpot_hist = proto;
+    res.itl_hist = proto;
+    res.e2el_hist = proto;
+
+    std::vector<double> ttfts, tpots, e2els;
+    std::vector<double> ttfts_intended, e2els_intended, send_lags;
+    const bool open_loop = arrival_is_open_loop(res.arrival);
+    if (!open_loop) res.latency_definition = "service";
+    for (const auto& r : res.requests) {
+        if (!r.success) {
+            res.failed++;
+            continue;
+        }
+        res.completed++;
+        res.total_input += r.prompt_len;
+        res.total_output += r.output_len;
+        ttfts.push_back(r.ttft_ms);
+        e2els.push_back(r.e2el_ms);
+        res.ttft_hist.record(r.ttft_ms);
+        res.e2el_hist.record(r.e2el_ms);
+        if (open_loop) {
+            ttfts_intended.push_back(r.ttft_ms + r.send_lag_ms);
+            e2els_intended.push_back(r.e2el_ms + r.send_lag_ms);
+            send_lags.push_back(r.send_lag_ms);
+        }
+        if (r.output_len > 1) {
+            double tpot = (r.e2el_ms - r.ttft_ms) / (r.output_len - 1);
+            tpots.push_back(tpot);
+            res.tpot_hist.record(tpot);
+        }
+        for (double itl : r.itl_ms) res.itl_hist.record(itl);
+    }
+
+    if (res.duration_s > 0) {
+        res.request_throughput = res.completed / res.duration_s;
+        res.output_throughput = res.total_output / res.duration_s;
+        res.total_token_throughput = (res.total_input + res.total_output) / res.duration_s;
+    }
+
+    res.mean_ttft_service_ms = loadgen_mean(ttfts);
+    res.median_ttft_service_ms = loadgen_percentile(ttfts, 50);
+    res.p99_ttft_service_ms = loadgen_percentile(ttfts, 99);
+    res.mean_e2el_service_ms = loadgen_mean(e2els);
+    res.median_e2el_service_ms = loadgen_percentile(e2els, 50);
+    res.p99_e2el_service_ms = loadgen_percentile(e2els, 99);
+    res.mean_ttft_intended_ms = loadgen_mean(ttfts_intended);
+    res.median_ttft_intended_ms = loadgen_percentile(ttfts_intended, 50);
+    res.p99_ttft_intended_ms = loadgen_percentile(ttfts_intended, 99);
+    res.mean_e2el_intended_ms = loadgen_mean(e2els_intended);
+    res.median_e2el_intended_ms = loadgen_percentile(e2els_intended, 50);
+    res.p99_e2el_intended_ms = loadgen_percentile(e2els_intended, 99);
+    res.mean_send_lag_ms = loadgen_mean(send_lags);
+    res.p99_send_lag_ms = loadgen_percentile(send_lags, 99);
+    res.max_send_lag_ms = loadgen_percentile(send_lags, 100);
+
+    bool intended = res.latency_definition == "response_time";
+    res.mean_ttft_ms = intended ? res.mean_ttft_intended_ms : res.mean_ttft_service_ms;
+    res.median_ttft_ms = intended ? res.median_ttft_intended_ms : res.median_ttft_service_ms;
+    res.p99_ttft_ms = intended ? res.p99_ttft_intended_ms : res.p99_ttft_service_ms;
+    res.mean_e2el_ms = intended ? res.mean_e2el_intended_ms : res.mean_e2el_service_ms;
+    res.median_e2el_ms = intended ? res.median_e2el_intended_ms : res.median_e2el_service_ms;
+    res.p99_e2el_ms = intended ? res.p99_e2el_intended_ms : res.p99_e2el_service_ms;
+
+    res.mean_tpot_ms = loadgen_mean(tpots);
+    res.median_tpot_ms = loadgen_percentile(tpots, 50);
+    res.p99_tpot_ms = loadgen_percentile(tpots, 99);
+
+    res.ttft_pct = percentile_set(res.ttft_hist);
+    res.tpot_pct = percentile_set(res.tpot_hist);
+    res.itl_pct = percentile_set(res.itl_hist);
+    res.e2el_pct = percentile_set(res.e2el_hist);
+    res.mean_itl_ms = res.itl_pct.mean;
+    res.median_itl_ms = res.itl_pct.p50;
+    res.p99_itl_ms = res.itl_pct.p99;
+}
+
+inline void print_benchmark_result(const BenchmarkResult& res) {
+    auto row = [](const std::string& name, double v) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10)
+                  << std::fixed << std::setprecision(2) << v << std::endl;
+    };
+    auto row_int = [](const std::string& name, long long v) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << v << std::endl;
+    };
+    std::cout << "============ Serving Benchmark Result ============" << std::endl;
+    row_int("Successful requests:", res.completed);
+    row_int("Failed requests:", res.failed);
+    row("Benchmark duration (s):", res.duration_s);
+    row_int("Total input tokens:", res.total_input);
+    row_int("Total generated tokens:", res.total_output);
+    row("Request throughput (req/s):", res.request_throughput);
+    row("Output token throughput (tok/s):", res.output_throughput);
+    row("Total Token throughput (tok/s):", res.total_token_throughput);
+    row("Mean TTFT (ms):", res.mean_ttft_ms);
+    row("Median TTFT (ms):", res.median_ttft_ms);
+    row("P99 TTFT (ms):", res.p99_ttft_ms);
+    row("Mean TPOT (ms):", res.mean_tpot_ms);
+    row("Median TPOT (ms):", res.median_tpot_ms);
+    row("P99 TPOT (ms):", res.p99_tpot_ms);
+    row("Mean ITL (ms):", res.mean_itl_ms);
+    row("Median ITL (ms):", res.median_itl_ms);
+    row("P99 ITL (ms):", res.p99_itl_ms);
+    row("P99.9 ITL (ms):", res.itl_pct.p999);
+    row("Max ITL (ms):", res.itl_pct.max);
+    row("Mean E2EL (ms):", res.mean_e2el_ms);
+    row("Median E2EL (ms):", res.median_e2el_ms);
+    row("P99 E2EL (ms):", res.p99_e2el_ms);
+    std::cout << "--------------- Client connections ---------------" << std::endl;
+    row_int("New connections opened:", res.connections_opened);
+    row("Connection reuse ratio:", res.connection_reuse_ratio);
+    row("P99 connect time (ms):", res.connect_pct.p99);
+    std::cout << "------------------ Client load -------------------" << std::endl;
+    row_int("Client worker threads:", res.client.threads);
+    row("Max worker CPU utilisation:", res.client.worker_util_max);
+    row("Mean worker CPU utilisation:", res.client.worker_util_mean);
+    row("Aggregator CPU utilisation:", res.client.aggregator_util);
+    std::cout << "------------------ Steady state ------------------" << std::endl;
+    if (res.steady.detected) {
+        row("Window start (s):", res.steady.window_start_s);
+        row("Window end (s):", res.steady.window_end_s);
+        row_int("Requests inside window:", res.steady.requests);
+        row("Mean in-flight requests:", res.steady.mean_concurrency);
+        row("Request throughput (req/s):", res.steady.request_throughput);
+        row("Output token throughput (tok/s):", res.steady.output_throughput);
+        row("Total Token throughput (tok/s):", res.steady.total_token_throughput);
+        row("Median TTFT (ms):", res.steady.median_ttft_ms);
+        row("Median TPOT (ms):", res.steady.median_tpot_ms);
+        row("Median ITL (ms):", res.steady.median_itl_ms);
+        row("Median E2EL (ms):", res.steady.median_e2el_ms);
+    } else {
+        std::cout << "Not detected (concurrency or throughput never settled)" << std::endl;
+    }
+    if (res.adaptive.enabled) {
+        std::cout << "---------------- Adaptive sampling ---------------" << std::endl;
+        std::cout << std::left << std::setw(40) << "Converged:" << std::right << std::setw(10)
+                  << (res.convergence.converged ? "yes" : "no") << std::endl;
+        row_int("Requests sent:", static_cast<long long>(res.requests.size()));
+        row_int("Request cap:", res.max_prompts);
+        row("Target CI half-width (%):", res.adaptive.target_rel_ci * 100);
+        row("Median TPOT CI half-width (%):", res.convergence.tpot_rel_ci * 100);
+        row("Median E2EL CI half-width (%):", res.convergence.e2el_rel_ci * 100);
+        row("Throughput CI half-width (%):", res.convergence.tput_rel_ci * 100);
+    }
+    if (arrival_is_open_loop(res.arrival)) {
+        std::cout << "----- Coordinated omission (" << res.latency_definition << " latency above) -----" << std::endl;
+        row("Median TTFT from intended start (ms):", res.median_ttft_intended_ms);
+        row("P99 TTFT from intended start (ms):", res.p99_ttft_intended_ms);
+        row("Median E2EL from intended start (ms):", res.median_e2el_intended_ms);
+        row("P99 E2EL from intended start (ms):", res.p99_e2el_intended_ms);
+        row("P99 send lag behind schedule (ms):", res.p99_send_lag_ms);
+        row("Max send lag behind schedule (ms):", res.max_send_lag_ms);
+    }
+    std::cout << "==================================================" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+// Summary fields of a run (no per-request arrays), in the order the result
+// files have always listed them. Tracks add their own derived fields.
+inline JsonValue benchmark_summary_json(const BenchmarkResult& res) {
+    JsonValue s = JsonValue::object();
+    s.set("successful_requests", res.completed);
+    s.set("benchmark_duration", res.duration_s);
+    s.set("total_input_tokens", res.total_input);
+    s.set("total_generated_tokens", res.total_output);
+    s.set("request_throughput", res.request_throughput);
+    s.set("output_throughput", res.output_throughput);
+    s.set("total_token_throughput", res.total_token_throughput);
+    s.set("mean_ttft_ms", res.mean_ttft_ms);
+    s.set("median_ttft_ms", res.median_ttft_ms);
+    s.set("p99_ttft_ms", res.p99_ttft_ms);
+    s.set("mean_tpot_ms", res.mean_tpot_ms);
+    s.set("median_tpot_ms", res.median_tpot_ms);
+    s.set("p99_tpot_ms", res.p99_tpot_ms);
+    s.set("mean_itl_ms", res.mean_itl_ms);
+    s.set("median_itl_ms", res.median_itl_ms);
+    s.set("p99_itl_ms", res.p99_itl_ms);
+    s.set("mean_e2el_ms", res.mean_e2el_ms);
+    s.set("median_e2el_ms", res.median_e2el_ms);
+    s.set("p99_e2el_ms", res.p99_e2el_ms);
+    s.set("latency_definition", res.latency_definition);
+    s.set("median_ttft_service_ms", res.median_ttft_service_ms);
+    s.set("p99_ttft_service_ms", res.p99_ttft_service_ms);
+    s.set("median_e2el_service_ms", res.median_e2el_service_ms);
+    s.set("p99_e2el_service_ms", res.p99_e2el_service_ms);
+    if (arrival_is_open_loop(res.arrival)) {
+        s.set("median_ttft_intended_ms", res.median_ttft_intended_ms);
+        s.set("p99_ttft_intended_ms", res.p99_ttft_intended_ms);
+        s.set("median_e2el_intended_ms", res.median_e2el_intended_ms);
+        s.set("p99_e2el_intended_ms", res.p99_e2el_intended_ms);
+        s.set("p99_send_lag_ms", res.p99_send_lag_ms);
+        s.set("max_send_lag_ms", res.max_send_lag_ms);
+    }
+    auto pct_fields = [&s](const std::string& name, const PercentileSet& p) {
+        s.set("p90_" + name + "_ms", p.p90);
+        s.set("p95_" + name + "_ms", p.p95);
+        s.set("p99_9_" + name + "_ms", p.p999);
+        s.set("max_" + name + "_ms", p.max);
+    };
+    pct_fields("ttft", res.ttft_pct);
+    pct_fields("tpot", res.tpot_pct);
+    pct_fields("itl", res.itl_pct);
+    pct_fields("e2el", res.e2el_pct);
+    s.set("itl_histogram", res.itl_hist.encode());
+    s.set("connections_opened", res.connections_opened);
+    s.set("connection_reuse_ratio", res.connection_reuse_ratio);
+    s.set("median_connect_ms", res.connect_pct.p50);
+    s.set("p99_connect_ms", res.connect_pct.p99);
+    s.set("max_connect_ms", res.connect_pct.max);
+    s.set("client_threads", res.client.threads);
+    s.set("client_worker_util_max", res.client.worker_util_max);
+    s.set("client_worker_util_mean", res.client.worker_util_mean);
+    s.set("client_aggregator_util", res.client.aggregator_util);
+    const SteadyStateSummary& st = res.steady;
+    s.set("steady_state_detected", st.detected);
+    s.set("steady_window_start_s", st.window_start_s);
+    s.set("steady_window_end_s", st.window_end_s);
+    s.set("steady_duration", st.duration_s());
+    s.set("steady_requests", st.requests);
+    s.set("steady_mean_concurrency", st.mean_concurrency);
+    s.set("steady_request_throughput", st.request_throughput);
+    s.set("steady_output_throughput", st.output_throughput);
+    s.set("steady_total_token_throughput", st.total_token_throughput);
+    s.set("steady_median_ttft_ms", st.median_ttft_ms);
+    s.set("steady_p99_ttft_ms", st.p99_ttft_ms);
+    s.set("steady_median_tpot_ms", st.median_tpot_ms);
+    s.set("steady_p99_tpot_ms", st.p99_tpot_ms);
+    s.set("steady_median_itl_ms", st.median_itl_ms);
+    s.set("steady_p99_itl_ms", st.p99_itl_ms);
+    s.set("steady_median_e2el_ms", st.median_e2el_ms);
+    s.set("steady_p99_e2el_ms", st.p99_e2el_ms);
+    if (res.adaptive.enabled) {
+        // Infinite intervals (too few samples to check) are written as null.
+        auto ci = [](double v) { return std::isinf(v) ? JsonValue(nullptr) : JsonValue(v); };
+        JsonValue a = JsonValue::object();
+        a.set("target_rel_ci", res.adaptive.target_rel_ci);
+        a.set("min_prompts", res.adaptive.min_prompts);
+        a.set("max_prompts", res.max_prompts);
+        a.set("prompts_sent", static_cast<long long>(res.requests.size()));
+        a.set("converged", res.convergence.converged);
+        a.set("checks", res.convergence.checks);
+        a.set("samples_at_last_check", res.convergence.samples);
+        a.set("median_tpot_rel_ci", ci(res.convergence.tpot_rel_ci));
+        a.set("median_e2el_rel_ci", ci(res.convergence.e2el_rel_ci));
+        a.set("throughput_rel_ci", ci(res.convergence.tput_rel_ci));
+        s.set("adaptive_sampling", a);
+    }
+    return s;
+}
+
+// The request rate as benchmark_serving.py records it: a number, or "inf".
+inline JsonValue request_rate_json(const ArrivalConfig& arrival) {
+    if (std::isinf(arrival.request_rate)) return JsonValue("inf");
+    return JsonValue(arrival.request_rate);
+}
+
+// ============================================
+// Load Generator Session
+// ============================================
+// What a sweep keeps from one run to the next: the client (worker threads and
+// their keep-alive connection pools, sized for the largest CONC so later
+// points ride on connections earlier ones opened). Prompts are not shared:
+// each point has its own seed (prompt_seed), so no point resends prompts the
+// server has cached; the last corpus is kept for a rerun of the same point.
+class LoadGenSession {
+public:
+    // Sizes the client for the largest run up front.
+    void reserve(int max_concurrency) {
+        reserve_concurrency_ = max_concurrency;
+    }
+
+    ShardedClient& client(const LoadGenConfig& cfg) {
+        if (!client_ || client_->capacity() < cfg.max_concurrency || client_threads_ != cfg.client_threads ||
+            client_pin_ != cfg.pin_client_threads) {
+            client_.reset();
+            client_.reset(new ShardedClient(std::max(cfg.max_concurrency, reserve_concurrency_), cfg.client_threads,
+                                            cfg.pin_client_threads));
+            client_threads_ = cfg.client_threads;
+            client_pin_ = cfg.pin_client_threads;
+        }
+        client_->set_concurrency(cfg.max_concurrency);
+        return *client_;
+    }
+
+    const std::vector<PromptSpec>& prompts(const LoadGenConfig& cfg) {
+        std::ostringstream key;
+        key << cfg.isl << '/' << cfg.osl << '/' << cfg.random_range_ratio << '/' << cfg.seed << '/'
+            << cfg.prompt_format << '/' << cfg.token_id_lo << '/' << cfg.token_id_hi;
+        if (key.str() == corpus_key_ && static_cast<int>(corpus_.size()) >= cfg.num_prompts) {
+            std::cout << "INFO: Reusing " << cfg.num_prompts << " of " << corpus_.size() << " generated prompts"
+                      << std::endl;
+            return corpus_;
+        }
+        std::cout << "INFO: Generating " << cfg.num_prompts << " random prompts (ISL=" << cfg.isl
+                  << ", OSL=" << cfg.osl << ", range ratio=" << cfg.random_range_ratio << ", seed=" << cfg.seed
+                  << ")" << std::endl;
+        corpus_ = generate_random_prompts(cfg);
+        corpus_key_ = key.str();
+        return corpus_;
+    }
+
+private:
+    std::unique_ptr<ShardedClient> client_;
+    int client_threads_ = 0;                    // settings client_ was built with
+    bool client_pin_ = true;
+    std::vector<PromptSpec> corpus_;
+    std::string corpus_key_;
+    int reserve_concurrency_ = 0;
+};
+
+// ============================================
+// Entry Point
+// ============================================
+inline int run_load_generator(const LoadGenConfig& cfg, BenchmarkResult& res, LoadGenSession& session) {
+    static bool curl_initialized = false;
+    if (!curl_initialized) {
+        curl_global_init(CURL_GLOBAL_ALL);
+        curl_initialized = true;
+    }
+
+    if (cfg.num_prompts <= 0) {
+        std::cerr << "ERROR: NUM_PROMPTS must be positive" << std::endl;
+        return 1;
+    }
+    const std::vector<PromptSpec>& prompts = session.prompts(cfg);
+    const size_t num_prompts = static_cast<size_t>(cfg.num_prompts);
+    if (cfg.prompt_format == "token_ids") {
+        std::cout << "INFO: Sending pre-tokenized prompts to " << request_path(cfg)
+                  << (cfg.use_chat_template ? " (chat template not applied)" : "") << std::endl;
+    }
+
+    // Lives across warmup and the measured run (and across the runs of a
+    // session) so the measured requests ride on already-established
+    // keep-alive connections. Warmup only needs to open those connections;
+    // the ramp-up is cut by the steady window.
+    ShardedClient& client = session.client(cfg);
+
+    if (cfg.num_warmups > 0) {
+        std::cout << "INFO: Warming up with " << cfg.num_warmups << " requests..." << std::endl;
+        // Not a measured prompt: that one would then be a prefix-cache hit.
+        LoadGenConfig warm_gen = cfg;
+        warm_gen.seed = ~cfg.seed;
+        warm_gen.num_prompts = 1;
+        std::vector<PromptSpec> warmups(cfg.num_warmups, generate_random_prompts(warm_gen).front());
+        LoadGenConfig warm_cfg = cfg;
+        warm_cfg.adaptive.enabled = false;
+        std::vector<RequestResult> warm =
+            client.run(warm_cfg, warmups, std::vector<double>(warmups.size(), 0.0), nullptr);
+        if (!warm.front().success) {
+            std::cerr << "ERROR: Warmup request failed: " << warm.front().error << std::endl;
+            return 1;
+        }
+        std::cout << "INFO: Warmup completed" << std::endl;
+    }
+
+    std::vector<double> send_offsets;
+    std::string err;
+    if (!build_arrival_schedule(cfg.arrival, num_prompts, send_offsets, err)) {
+        std::cerr << "ERROR: " << err << std::endl;
+        return 1;
+    }
+    if (send_offsets.size() < num_prompts) {
+        std::cout << "WARNING: Arrival trace has " << send_offsets.size() << " entries; running "
+                  << send_offsets.size() << " of " << num_prompts << " prompts" << std::endl;
+    }
+    send_offsets.resize(std::min(send_offsets.size(), num_prompts));
+
+    std::cout << "INFO: Starting main benchmark run (max concurrency " << cfg.max_concurrency
+              << ", " << client.active_threads() << " client threads, arrivals " << describe_arrival(cfg.arrival) << ")" << std::endl;
+    if (cfg.adaptive.enabled) {
+        std::cout << "INFO: Adaptive sampling: " << cfg.adaptive.min_prompts << " to " << send_offsets.size()
+                  << " requests, until the 95% CIs are within " << cfg.adaptive.target_rel_ci * 100 << "%" << std::endl;
+    }
+    res = BenchmarkResult();
+    res.arrival = cfg.arrival;
+    res.prompt_format = cfg.prompt_format;
+    res.latency_definition = cfg.latency_definition;
+    res.adaptive = cfg.adaptive;
+    res.max_prompts = static_cast<int>(send_offsets.size());
+    client.reset_connection_stats();
+    ResultJournal journal;
+    if (!cfg.journal_path.empty()) {
+        if (journal.open(cfg.journal_path, cfg.journal_sync_every)) {
+            journal.write_header(cfg);
+            std::cout << "INFO: Journaling completed requests to " << cfg.journal_path << std::endl;
+        } else {
+            std::cout << "WARNING: Cannot open result journal " << cfg.journal_path << "; running without it" << std::endl;
+        }
+    }
+    res.requests = client.run(cfg, prompts, send_offsets, &res.duration_s, &journal);
+    journal.write_end(res.duration_s);
+    journal.close();
+    res.convergence = client.convergence();
+    compute_benchmark_metrics(res, cfg.hist_significant_digits);
+    res.client = client.utilisation();
+    ConnectionStats conn = client.connection_stats();
+    res.connections_opened = conn.new_connections;
+    res.connection_reuse_ratio = conn.reuse_ratio();
+    res.connect_pct = percentile_set(conn.connect_ms);
+    res.steady = detect_steady_state(res.requests, cfg.max_concurrency, cfg.steady_tolerance);
+    print_benchmark_result(res);
+    if (res.client.worker_util_max > 0.8) {
+        std::cout << "WARNING: A client worker thread was " << static_cast<int>(res.client.worker_util_max * 100)
+                  << "% busy; results may be client-bound. Raise CLIENT_THREADS." << std::endl;
+    }
+
+    if (res.completed == 0) {
+        std::cerr << "ERROR: All requests failed. First error: " << res.requests.front().error << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+inline int run_load_generator(const LoadGenConfig& cfg, BenchmarkResult& res) {
+    LoadGenSession session;
+    return run_load_generator(cfg, res, session);
+}
+
+// ============================================
+// Journal Recovery
+// ============================================
+// Rebuilds the summary of a run that died before writing its result JSON from
+// the requests its journal recorded. Throughput divides by the span up to the
+// last completion, so a partial run reads as the rate it was sustaining.
+inline int recover_from_journal(const std::string& journal_path, BenchmarkResult& res, JsonValue* header = nullptr) {
+    JournalContents journal;
+    std::string err;
+    if (!read_result_journal(journal_path, journal, &err)) {
+        std::cerr << "ERROR: " << err << std::endl;
+        return 1;
+    }
+    const JsonValue& h = journal.header;
+    res = BenchmarkResult();
+    res.arrival.mode = h["arrival_mode"].as_string("inf");
+    res.arrival.request_rate = h["request_rate"].is_number() ? h["request_rate"].as_double() : INFINITY;
+    res.arrival.burstiness = h["burstiness"].as_double(1.0);
+    res.prompt_format = h["prompt_format"].as_string("text");
+    res.latency_definition = h["latency_definition"].as_string("service");
+    res.duration_s = journal.duration_s;
+    res.requests = std::move(journal.requests);
+    if (header) *header = h;
+
+    std::cout << "INFO: " << journal_path << ": " << res.requests.size() << " of " << h["num_prompts"].as_int()
+              << " requests journaled" << (journal.complete ? " (run finished)" : " (run did not finish)") << std::endl;
+    if (journal.torn_lines > 0) {
+        std::cout << "WARNING: Ignored a torn record at the end of the journal" << std::endl;
+    }
+    compute_benchmark_metrics(res);
+    res.steady = detect_steady_state(res.requests, static_cast<int>(h["max_concurrency"].as_int(1)));
+    print_benchmark_result(res);
+    if (res.completed == 0) {
+        std::cerr << "ERROR: The journal holds no successful request" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# ============================================
+# Load Generator Environment Variables (shared)
+# ============================================
+# Optional knobs of the native load generator, common to every track. Each
+# track's specific_conc_var.sh sources this file; uncomment what you need
+# here, or export it yourself before running the benchmark binary.
+
+# Arrival process (default: REQUEST_RATE=inf, closed loop capped by CONC)
+# export REQUEST_RATE=2.0             # req/s
+# export ARRIVAL_MODE=poisson         # inf | poisson | gamma | constant | trace
+# export BURSTINESS=1.0               # gamma shape; < 1 is burstier than Poisson
+# export ARRIVAL_TRACE=arrivals.txt   # one send offset (s) per line, ARRIVAL_MODE=trace
+# export LATENCY_DEFINITION=service   # service | response_time (from intended send; open-loop ARRIVAL_MODE only)
+
+# Measurement
+# export HIST_SIGNIFICANT_DIGITS=3    # HDR histogram precision for latency percentiles (1-5)
+# export NUM_WARMUPS=                 # warmup requests before the measured run (default: CONC, one per connection)
+# export STEADY_TOLERANCE=0.15        # steady-state window: max per-bin deviation from median output throughput
+# export ADAPTIVE_SAMPLES=1           # run until median TPOT/E2E and throughput 95% CIs converge; NUM_PROMPTS is then ignored
+# export ADAPTIVE_CI=0.02             # adaptive: target CI half-width relative to the estimate
+# export ADAPTIVE_MIN_PROMPTS=        # adaptive: requests before stopping is considered (default: max(2 x CONC, 40))
+# export ADAPTIVE_MAX_PROMPTS=        # adaptive: request cap (default: max(CONC x 10, 400))
+# export TRACE_EXPORT=1               # write <RESULT_FILENAME>.trace.json (Perfetto/Chrome trace); 2 adds every token chunk
+
+# Client and requests
+# export CLIENT_THREADS=0             # load generator worker threads (0 = auto, 1 per 32 streams); CLIENT_PIN=0 disables CPU pinning
+# export PROMPT_FORMAT=token_ids      # send exactly ISL pre-tokenized ids instead of text
+#                                     # (prompt: [ids] on /v1/completions; input_ids on SGLang's /generate)
+
+# Server layout
+# export SERVER_PORTS=8888,8889       # one port per data-parallel server instance (e.g. TP=4 x 2); streams spread over them
+# export NUM_GPUS=                    # GPUs for per-GPU throughput (default: TP x instances; NUM_INSTANCES for replicas behind one port)
@@ -0,0 +1,217 @@
+// ============================================
+// Columnar Per-Request Result Store
+// ============================================
+// Every request of one run in a compact binary sidecar next to the summary
+// JSON, for later analysis. The summary keeps only aggregates; this keeps the
+// raw per-request numbers, including every inter-token gap (a CONC=128 run is
+// over a million chunks).
+//
+// Layout: a fixed header, then one little-endian column after another, each
+// 8-byte aligned so a reader can mmap the file and use the columns in place:
+//
+//   per request (num_requests rows)
+//     prompt_len    int32    server-reported ISL
+//     output_len    int32    server-reported OSL
+//     success       uint8
+//     send_delta_us int32    send time minus the previous row's (row 0: from run start)
+//     ttft_us       uint32
+//     e2el_us       uint32
+//     chunks        uint32   streamed chunks of this request
+//   per chunk (num_chunks rows, request by request)
+//     gap_us        uint32   time since the previous chunk (first chunk: TTFT)
+//     tokens        uint16   tokens carried by the chunk (several with MTP)
+//
+// Times are microseconds. Send times and chunk arrivals are stored as deltas,
+// so each fits 32 bits; a request's chunk range is the prefix sum of `chunks`.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "workload.hpp"
+
+static const char REQUEST_COLUMNS_MAGIC[8] = {'L', 'G', 'R', 'E', 'Q', 'C', 'O', 'L'};
+static const uint32_t REQUEST_COLUMNS_VERSION = 1;
+
+enum RequestColumn : uint32_t {
+    RCOL_PROMPT_LEN = 0,
+    RCOL_OUTPUT_LEN,
+    RCOL_SUCCESS,
+    RCOL_SEND_DELTA_US,
+    RCOL_TTFT_US,
+    RCOL_E2EL_US,
+    RCOL_CHUNKS,
+    RCOL_GAP_US,
+    RCOL_TOKENS,
+    RCOL_COUNT,
+};
+
+struct RequestColumnsHeader {
+    char magic[8];
+    uint32_t version = REQUEST_COLUMNS_VERSION;
+    uint32_t num_requests = 0;
+    uint64_t num_chunks = 0;
+    uint64_t offset[RCOL_COUNT] = {};           // byte offset of each column from the file start
+};
+
+inline uint32_t request_columns_us(double ms) {
+    double us = ms * 1000.0 + 0.5;
+    if (us <= 0) return 0;
+    return us >= 4294967295.0 ? UINT32_MAX : static_cast<uint32_t>(us);
+}
+
+inline bool write_request_columns(const std::string& path, const std::vector<RequestResult>& requests) {
+    RequestColumnsHeader h;
+    std::memcpy(h.magic, REQUEST_COLUMNS_MAGIC, sizeof(h.magic));
+    h.num_requests = static_cast<uint32_t>(requests.size());
+
+    std::vector<int32_t> prompt_len, output_len, send_delta_us;
+    std::vector<uint8_t> success;
+    std::vector<uint32_t> ttft_us, e2el_us, chunks, gap_us;
+    std::vector<uint16_t> tokens;
+    int64_t prev_send_us = 0;
+    for (const auto& r : requests) {
+        prompt_len.push_back(r.prompt_len);
+        output_len.push_back(r.output_len);
+        success.push_back(r.success ? 1 : 0);
+        int64_t send_us = static_cast<int64_t>(r.send_time_s * 1e6 + 0.5);
+        send_delta_us.push_back(static_cast<int32_t>(send_us - prev_send_us));
+        prev_send_us = send_us;
+        ttft_us.push_back(request_columns_us(r.ttft_ms));
+        e2el_us.push_back(request_columns_us(r.e2el_ms));
+
+        uint32_t n = static_cast<uint32_t>(r.chunk_tokens.size());
+        chunks.push_back(n);
+        for (uint32_t j = 0; j < n; j++) {
+            gap_us.push_back(request_columns_us(j == 0 ? r.ttft_ms : r.itl_ms[j - 1]));
+            tokens.push_back(static_cast<uint16_t>(std::max(0, std::min<int32_t>(r.chunk_tokens[j], UINT16_MAX))));
+        }
+        h.num_chunks += n;
+    }
+
+    struct Column { const void* data; size_t bytes; };
+    Column cols[RCOL_COUNT] = {
+        {prompt_len.data(), prompt_len.size() * sizeof(int32_t)},
+        {output_len.data(), output_len.size() * sizeof(int32_t)},
+        {success.data(), success.size()},
+        {send_delta_us.data(), send_delta_us.size() * sizeof(int32_t)},
+        {ttft_us.data(), ttft_us.size() * sizeof(uint32_t)},
+        {e2el_us.data(), e2el_us.size() * sizeof(uint32_t)},
+        {chunks.data(), chunks.size() * sizeof(uint32_t)},
+        {gap_us.data(), gap_us.size() * sizeof(uint32_t)},
+        {tokens.data(), tokens.size() * sizeof(uint16_t)},
+    };
+    auto align8 = [](uint64_t x) { return (x + 7) & ~uint64_t(7); };
+    uint64_t pos = align8(sizeof(h));
+    for (uint32_t c = 0; c < RCOL_COUNT; c++) {
+        h.offset[c] = pos;
+        pos = align8(pos + cols[c].bytes);
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    static const char zeros[8] = {};
+    uint64_t written = sizeof(h);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (uint32_t c = 0; c < RCOL_COUNT; c++) {
+        out.write(zeros, h.offset[c] - written);
+        out.write(static_cast<const char*>(cols[c].data), cols[c].bytes);
+        written = h.offset[c] + cols[c].bytes;
+    }
+    out.write(zeros, pos - written);
+    return out.good();
+}
+
+// Read-only mmap view of a request columns file. Column accessors point
+// straight into the mapping; only the per-request chunk offsets are built.
+class RequestColumnsView {
+public:
+    RequestColumnsView() = default;
+    RequestColumnsView(const RequestColumnsView&) = delete;
+    RequestColumnsView& operator=(const RequestColumnsView&) = delete;
+    ~RequestColumnsView() { close(); }
+
+    bool open(const std::string& path, std::string* error = nullptr) {
+        close();
+        auto fail = [&](const std::string& msg) {
+            if (error) *error = msg;
+            close();
+            return false;
+        };
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail("cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(RequestColumnsHeader))) {
+            ::close(fd);
+            return fail("truncated file " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* base = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) return fail("cannot mmap " + path);
+        base_ = static_cast<const char*>(base);
+
+        const auto* h = reinterpret_cast<const RequestColumnsHeader*>(base_);
+        if (std::memcmp(h->magic, REQUEST_COLUMNS_MAGIC, sizeof(h->magic)) != 0) return fail("not a request columns file");
+        if (h->version != REQUEST_COLUMNS_VERSION) return fail("unsupported version " + std::to_string(h->version));
+        header_ = *h;
+        const size_t widths[RCOL_COUNT] = {4, 4, 1, 4, 4, 4, 4, 4, 2};
+        for (uint32_t c = 0; c < RCOL_COUNT; c++) {
+            uint64_t rows = c < RCOL_GAP_US ? header_.num_requests : header_.num_chunks;
+            if (header_.offset[c] % 8 != 0 || header_.offset[c] + rows * widths[c] > size_) {
+                return fail("corrupt column table");
+            }
+        }
+
+        chunk_begin_.resize(header_.num_requests + 1);
+        chunk_begin_[0] = 0;
+        const uint32_t* n = chunks();
+        for (uint32_t i = 0; i < header_.num_requests; i++) chunk_begin_[i + 1] = chunk_begin_[i] + n[i];
+        if (chunk_begin_.back() != header_.num_chunks) return fail("chunk counts do not add up");
+        return true;
+    }
+
+    void close() {
+        if (base_) munmap(const_cast<char*>(base_), size_);
+        base_ = nullptr;
+        size_ = 0;
+        header_ = RequestColumnsHeader();
+        chunk_begin_.clear();
+    }
+
+    size_t num_requests() const { return header_.num_requests; }
+    uint64_t num_chunks() const { return header_.num_chunks; }
+
+    const int32_t* prompt_len() const { return column<int32_t>(RCOL_PROMPT_LEN); }
+    const int32_t* output_len() const { return column<int32_t>(RCOL_OUTPUT_LEN); }
+    const uint8_t* success() const { return column<uint8_t>(RCOL_SUCCESS); }
+    const int32_t* send_delta_us() const { return column<int32_t>(RCOL_SEND_DELTA_US); }
+    const uint32_t* ttft_us() const { return column<uint32_t>(RCOL_TTFT_US); }
+    const uint32_t* e2el_us() const { return column<uint32_t>(RCOL_E2EL_US); }
+    const uint32_t* chunks() const { return column<uint32_t>(RCOL_CHUNKS); }
+    const uint32_t* gap_us() const { return column<uint32_t>(RCOL_GAP_US); }
+    const uint16_t* tokens() const { return column<uint16_t>(RCOL_TOKENS); }
+
+    // Chunks of request i are [chunk_begin(i), chunk_begin(i + 1)).
+    uint64_t chunk_begin(size_t i) const { return chunk_begin_[i]; }
+
+private:
+    template <typename T>
+    const T* column(RequestColumn c) const {
+        return base_ ? reinterpret_cast<const T*>(base_ + header_.offset[c]) : nullptr;
+    }
+
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+    RequestColumnsHeader header_;
+    std::vector<uint64_t> chunk_begin_;
+};
@@ -0,0 +1,221 @@
+// ============================================
+// Crash-Safe Result Journal
+// ============================================
+// The summary JSON is written once, after the last request. A client or
+// server crash late in a long run (CONC=128 on DeepSeek-R1 takes many
+// minutes) would otherwise lose every request that had already completed.
+// The journal appends one JSON line per finished request as it completes,
+// fsync'd in batches, so a partial summary can be rebuilt afterwards:
+//
+//   {"type":"header","model":...,"isl":...,"osl":...,"max_concurrency":...,...}
+//   {"type":"request","i":17,"success":true,"prompt_len":8192,...,"itl_ms":[...]}
+//   ...
+//   {"type":"end","duration_s":612.4}
+//
+// Records are appended by the aggregator thread only, so no locking. A torn
+// last line (the crash hit mid-write) is ignored on reading, as is anything
+// after it.
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "json.hpp"
+#include "workload.hpp"
+
+class ResultJournal {
+public:
+    ResultJournal() = default;
+    ResultJournal(const ResultJournal&) = delete;
+    ResultJournal& operator=(const ResultJournal&) = delete;
+    ~ResultJournal() { close(); }
+
+    // Truncates any previous journal at `path`. `sync_every` records (or one
+    // second, whichever comes first) go to disk per fsync.
+    bool open(const std::string& path, int sync_every) {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        path_ = path;
+        sync_every_ = sync_every > 0 ? sync_every : 1;
+        pending_ = 0;
+        last_sync_ = std::chrono::steady_clock::now();
+        return fd_ >= 0;
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+    const std::string& path() const { return path_; }
+
+    void write_header(const LoadGenConfig& cfg) {
+        if (fd_ < 0) return;
+        JsonValue h = JsonValue::object();
+        h.set("type", "header");
+        h.set("model", cfg.model);
+        h.set("isl", cfg.isl);
+        h.set("osl", cfg.osl);
+        h.set("max_concurrency", cfg.max_concurrency);
+        h.set("num_prompts", cfg.num_prompts);
+        h.set("prompt_format", cfg.prompt_format);
+        h.set("latency_definition", cfg.latency_definition);
+        h.set("arrival_mode", cfg.arrival.mode);
+        h.set("request_rate", std::isinf(cfg.arrival.request_rate) ? JsonValue("inf") : JsonValue(cfg.arrival.request_rate));
+        h.set("burstiness", cfg.arrival.burstiness);
+        buf_ += h.dump();
+        buf_ += '\n';
+        sync();
+    }
+
+    void append(size_t index, const RequestResult& r) {
+        if (fd_ < 0) return;
+        char num[64];
+        auto add_num = [&](const char* key, double v) {
+            snprintf(num, sizeof(num), ",\"%s\":%.4f", key, v);
+            buf_ += num;
+        };
+        snprintf(num, sizeof(num), "{\"type\":\"request\",\"i\":%zu,\"success\":%s", index, r.success ? "true" : "false");
+        buf_ += num;
+        snprintf(num, sizeof(num), ",\"prompt_len\":%d,\"output_len\":%d,\"slot\":%d", r.prompt_len, r.output_len, r.slot);
+        buf_ += num;
+        add_num("first_byte_ms", r.first_byte_ms);
+        add_num("ttft_ms", r.ttft_ms);
+        add_num("e2el_ms", r.e2el_ms);
+        add_num("intended_start_s", r.intended_start_s);
+        add_num("send_time_s", r.send_time_s);
+        add_num("send_lag_ms", r.send_lag_ms);
+        buf_ += ",\"itl_ms\":[";
+        for (size_t k = 0; k < r.itl_ms.size(); k++) {
+            snprintf(num, sizeof(num), k ? ",%.4f" : "%.4f", r.itl_ms[k]);
+            buf_ += num;
+        }
+        buf_ += "],\"chunk_tokens\":[";
+        for (size_t k = 0; k < r.chunk_tokens.size(); k++) {
+            snprintf(num, sizeof(num), k ? ",%d" : "%d", r.chunk_tokens[k]);
+            buf_ += num;
+        }
+        buf_ += "]";
+        if (!r.error.empty()) {
+            buf_ += ",\"error\":\"";
+            buf_ += json_escape(r.error);
+            buf_ += "\"";
+        }
+        buf_ += "}\n";
+
+        auto now = std::chrono::steady_clock::now();
+        if (++pending_ >= sync_every_ || now - last_sync_ >= std::chrono::seconds(1)) sync();
+    }
+
+    void write_end(double duration_s) {
+        if (fd_ < 0) return;
+        char line[96];
+        snprintf(line, sizeof(line), "{\"type\":\"end\",\"duration_s\":%.6f}\n", duration_s);
+        buf_ += line;
+        sync();
+    }
+
+    // Writes the buffered records and fsyncs. A failed write is reported once
+    // and disables the journal; the run itself carries on.
+    void sync() {
+        if (fd_ < 0 || buf_.empty()) return;
+        const char* p = buf_.data();
+        size_t left = buf_.size();
+        while (left > 0) {
+            ssize_t n = ::write(fd_, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                fprintf(stderr, "WARNING: Result journal %s: write failed, journaling stopped\n", path_.c_str());
+                ::close(fd_);
+                fd_ = -1;
+                buf_.clear();
+                return;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        buf_.clear();
+        fdatasync(fd_);
+        pending_ = 0;
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+
+    void close() {
+        sync();
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    int fd_ = -1;
+    std::string path_;
+    std::string buf_;
+    int sync_every_ = 64;
+    int pending_ = 0;
+    std::chrono::steady_clock::time_point last_sync_;
+};
+
+// ============================================
+// Reading a Journal
+// ============================================
+struct JournalContents {
+    JsonValue header;
+    std::vector<RequestResult> requests;        // completed requests, in completion order
+    bool complete = false;                      // the end record is present
+    double duration_s = 0.0;                    // from the end record, else the last completion
+    int torn_lines = 0;
+};
+
+inline bool read_result_journal(const std::string& path, JournalContents& out, std::string* error = nullptr) {
+    std::ifstream in(path);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    out = JournalContents();
+    std::string line;
+    double last_done_s = 0.0;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        JsonValue rec;
+        if (!json_parse(line, rec) || !rec.is_object()) {
+            out.torn_lines++;
+            break;
+        }
+        std::string type = rec["type"].as_string();
+        if (type == "header") {
+            out.header = rec;
+        } else if (type == "end") {
+            out.complete = true;
+            out.duration_s = rec["duration_s"].as_double();
+        } else if (type == "request") {
+            RequestResult r;
+            r.success = rec["success"].as_bool();
+            r.error = rec["error"].as_string();
+            r.prompt_len = static_cast<int>(rec["prompt_len"].as_int());
+            r.output_len = static_cast<int>(rec["output_len"].as_int());
+            r.slot = static_cast<int>(rec["slot"].as_int(-1));
+            r.first_byte_ms = rec["first_byte_ms"].as_double();
+            r.ttft_ms = rec["ttft_ms"].as_double();
+            r.e2el_ms = rec["e2el_ms"].as_double();
+            r.intended_start_s = rec["intended_start_s"].as_double();
+            r.send_time_s = rec["send_time_s"].as_double();
+            r.send_lag_ms = rec["send_lag_ms"].as_double();
+            for (const JsonValue& v : rec["itl_ms"].items()) r.itl_ms.push_back(v.as_double());
+            for (const JsonValue& v : rec["chunk_tokens"].items()) r.chunk_tokens.push_back(static_cast<int32_t>(v.as_int()));
+            last_done_s = std::max(last_done_s, r.send_time_s + r.e2el_ms / 1000.0);
+            out.requests.push_back(std::move(r));
+        }
+    }
+    if (out.header.is_null()) {
+        if (error) *error = path + " has no journal header";
+        return false;
+    }
+    if (!out.complete) out.duration_s = last_done_s;
+    return true;
+}
@@ -0,0 +1,145 @@
+// ============================================
+// Server Process Discovery
+// ============================================
+// Finds the process listening on a local port through /proc (the LISTEN
+// socket's inode in /proc/net/tcp{,6}, then the process holding that inode
+// open) and reads what identifies one server launch: the command line, the
+// tuning environment and the start time. Only works when the server runs in
+// the same PID namespace as the client (same container or host); otherwise
+// `pid` stays -1 and callers fall back to what the HTTP API reports.
+
+#pragma once
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Environment prefixes that change kernels, quantization or scheduling, e.g.
+// SGLANG_USE_AITER, ROCM_QUICK_REDUCE_QUANTIZATION, VLLM_ROCM_USE_AITER.
+static const char* const SERVER_ENV_KNOB_PREFIXES[] = {
+    "SGLANG_", "VLLM_", "ATOM_", "AITER_", "ROCM_", "HIP_", "HSA_", "RCCL_", "NCCL_", "TORCH_", "PYTORCH_",
+};
+
+struct ServerProcessInfo {
+    int pid = -1;
+    std::string cmdline;                        // arguments joined by spaces
+    std::vector<std::pair<std::string, std::string>> env_knobs;
+    long long start_time = 0;                   // unix seconds
+};
+
+inline std::string read_proc_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// Inode of the LISTEN socket bound to `port`, or 0.
+inline unsigned long long listening_socket_inode(int port) {
+    for (const char* table : {"/proc/net/tcp", "/proc/net/tcp6"}) {
+        std::ifstream in(table);
+        std::string line;
+        std::getline(in, line);                 // header
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string slot, local, remote, state, queues, timer, retransmits, uid, timeout;
+            unsigned long long inode = 0;
+            fields >> slot >> local >> remote >> state >> queues >> timer >> retransmits >> uid >> timeout >> inode;
+            size_t colon = local.rfind(':');
+            if (state != "0A" || colon == std::string::npos) continue;
+            if (std::strtol(local.c_str() + colon + 1, nullptr, 16) == port) return inode;
+        }
+    }
+    return 0;
+}
+
+inline int socket_owner_pid(unsigned long long inode) {
+    const std::string target = "socket:[" + std::to_string(inode) + "]";
+    DIR* proc = opendir("/proc");
+    if (!proc) return -1;
+    int owner = -1;
+    while (struct dirent* ent = readdir(proc)) {
+        char* end = nullptr;
+        long pid = std::strtol(ent->d_name, &end, 10);
+        if (*end != '\0' || pid <= 0) continue;
+        std::string fd_dir = std::string("/proc/") + ent->d_name + "/fd";
+        DIR* fds = opendir(fd_dir.c_str());
+        if (!fds) continue;
+        while (struct dirent* fd = readdir(fds)) {
+            char link[128];
+            ssize_t n = readlink((fd_dir + "/" + fd->d_name).c_str(), link, sizeof(link) - 1);
+            if (n > 0 && target.compare(0, std::string::npos, link, static_cast<size_t>(n)) == 0) {
+                owner = static_cast<int>(pid);
+                break;
+            }
+        }
+        closedir(fds);
+        if (owner >= 0) break;
+    }
+    closedir(proc);
+    return owner;
+}
+
+inline long long process_start_time(int pid) {
+    std::string stat = read_proc_file("/proc/" + std::to_string(pid) + "/stat");
+    size_t paren = stat.rfind(')');
+    if (paren == std::string::npos) return 0;
+    // Fields after the command name start at field 3 (state); starttime is field 22.
+    std::istringstream fields(stat.substr(paren + 2));
+    std::string field;
+    unsigned long long start_ticks = 0;
+    for (int i = 3; i <= 22 && fields >> field; i++) {
+        if (i == 22) start_ticks = std::strtoull(field.c_str(), nullptr, 10);
+    }
+    std::istringstream proc_stat(read_proc_file("/proc/stat"));
+    std::string line;
+    long long boot_time = 0;
+    while (std::getline(proc_stat, line)) {
+        if (line.compare(0, 6, "btime ") == 0) boot_time = std::atoll(line.c_str() + 6);
+    }
+    long ticks = sysconf(_SC_CLK_TCK);
+    return boot_time + static_cast<long long>(start_ticks / static_cast<unsigned long long>(ticks > 0 ? ticks : 100));
+}
+
+inline ServerProcessInfo find_server_process(int port) {
+    ServerProcessInfo info;
+    unsigned long long inode = listening_socket_inode(port);
+    if (inode == 0) return info;
+    info.pid = socket_owner_pid(inode);
+    if (info.pid < 0) return info;
+
+    const std::string dir = "/proc/" + std::to_string(info.pid);
+    std::string args = read_proc_file(dir + "/cmdline");
+    while (!args.empty() && args.back() == '\0') args.pop_back();
+    for (char& c : args) {
+        if (c == '\0') c = ' ';
+    }
+    info.cmdline = args;
+
+    std::string env = read_proc_file(dir + "/environ");
+    size_t pos = 0;
+    while (pos < env.size()) {
+        size_t end = env.find('\0', pos);
+        if (end == std::string::npos) end = env.size();
+        std::string entry = env.substr(pos, end - pos);
+        pos = end + 1;
+        size_t eq = entry.find('=');
+        if (eq == std::string::npos) continue;
+        for (const char* prefix : SERVER_ENV_KNOB_PREFIXES) {
+            if (entry.compare(0, std::char_traits<char>::length(prefix), prefix) == 0) {
+                info.env_knobs.emplace_back(entry.substr(0, eq), entry.substr(eq + 1));
+                break;
+            }
+        }
+    }
+    std::sort(info.env_knobs.begin(), info.env_knobs.end());
+    info.start_time = process_start_time(info.pid);
+    return info;
+}
@@ -0,0 +1,611 @@
+// ============================================
+// Sharded Multi-Threaded Client
+// ============================================
+// Splits the CONC concurrency slots across N worker threads, each pinned to
+// its own CPU and driving its own libcurl multi handle and keep-alive
+// connection pool. Workers claim the next due prompt from a shared atomic
+// cursor, so any free slot on any worker picks up work and the global
+// in-flight count never exceeds CONC.
+//
+// Workers do no bookkeeping beyond SSE parsing: every send, token chunk and
+// completion becomes a fixed-size TimingEvent pushed into the worker's own
+// single-producer ring. One aggregator thread drains all rings and builds the
+// per-request results, journaling each one as it completes and, with adaptive
+// sampling, deciding when enough have completed (adaptive_sampling.hpp). Each
+// thread measures its own CPU time, so a run can show that the client was not
+// the bottleneck.
+
+#pragma once
+
+#include <curl/curl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "connection_pool.hpp"
+#include "json.hpp"
+#include "result_journal.hpp"
+#include "spsc_ring.hpp"
+#include "sse_parser.hpp"
+#include "workload.hpp"
+
+// ============================================
+// Timing Events
+// ============================================
+enum TimingEventKind : uint8_t {
+    EVENT_SEND = 0,
+    EVENT_TOKEN = 1,
+    EVENT_DONE = 2,
+    EVENT_FIRST_BYTE = 3,
+};
+
+struct TimingEvent {
+    int64_t t_ns = 0;                           // steady clock, ns
+    uint32_t request = 0;                       // prompt index
+    uint8_t kind = EVENT_SEND;
+    uint8_t success = 0;                        // EVENT_DONE only
+    uint16_t slot = 0;                          // EVENT_SEND only: client-wide slot id
+    int32_t prompt_len = 0;                     // EVENT_DONE only
+    int32_t output_len = 0;                     // EVENT_DONE; EVENT_TOKEN: running count, -1 if not reported
+};
+
+inline int64_t steady_ns(SseClock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+inline double thread_cpu_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Pins the calling thread to one CPU of the process's allowed set.
+inline void pin_current_thread(int ordinal) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    std::vector<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+    }
+    if (cpus.empty()) return;
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(cpus[ordinal % cpus.size()], &one);
+    pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+}
+
+// Default worker count: one thread per 32 streams, capped by the CPUs left
+// after the aggregator.
+inline int auto_client_threads(int concurrency) {
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    int cap = std::max(1, hw - 1);
+    int want = (concurrency + 31) / 32;
+    return std::max(1, std::min(want, cap));
+}
+
+// ============================================
+// Per-Run Shared State
+// ============================================
+struct ClientRunState {
+    const LoadGenConfig* cfg = nullptr;
+    const std::vector<PromptSpec>* prompts = nullptr;
+    const std::vector<double>* send_offsets_s = nullptr;
+    bool open_loop = false;                     // send_offsets_s is an arrival schedule, not all zeros
+    SseClock::time_point start;
+    std::atomic<size_t> next{0};
+    // Prompts past this index are not claimed; lowered by the adaptive stop rule.
+    std::atomic<size_t> limit{0};
+    std::atomic<int> workers_running{0};
+    // Written by the worker that owns request i before it publishes EVENT_DONE.
+    std::vector<std::string> errors;
+    ResultJournal* journal = nullptr;           // aggregator only
+
+    SseClock::time_point due(size_t i) const {
+        return start + std::chrono::duration_cast<SseClock::duration>(
+                           std::chrono::duration<double>((*send_offsets_s)[i]));
+    }
+};
+
+struct ClientThreadStats {
+    double wall_s = 0.0;
+    double cpu_s = 0.0;
+    long long events = 0;
+    long long ring_full_waits = 0;
+
+    double utilisation() const { return wall_s > 0 ? cpu_s / wall_s : 0.0; }
+};
+
+class ClientShard;
+
+// ============================================
+// In-Flight Request State
+// ============================================
+struct InflightRequest {
+    ClientShard* shard = nullptr;
+    CURL* easy = nullptr;
+    int slot = -1;                              // connection pool slot
+    uint32_t index = 0;                         // prompt index
+    std::string body;
+    SseParser sse;
+    long http_code = 0;
+    std::string error_body;
+    bool got_first_byte = false;
+    int chunks = 0;
+    int prompt_len = 0;
+    int output_len = 0;
+};
+
+// ============================================
+// Worker Shard
+// ============================================
+class ClientShard {
+public:
+    ClientShard(int id, int slot_base, int slots, size_t ring_capacity)
+        : id_(id), slot_base_(slot_base), active_slots_(slots), pool_(slots), ring_(ring_capacity) {}
+
+    ConnectionPool& pool() { return pool_; }
+    int active_slots() const { return active_slots_; }
+    // How many of the pool's slots the next run may fill; the rest keep their
+    // connections for a later, larger run.
+    void set_active_slots(int n) { active_slots_ = std::max(0, std::min(n, pool_.size())); }
+    SpscRing<TimingEvent>& ring() { return ring_; }
+    const ClientThreadStats& stats() const { return stats_; }
+
+    // Never drops an event: if the aggregator falls behind, the worker waits.
+    void emit(const TimingEvent& ev) {
+        while (!ring_.try_push(ev)) {
+            stats_.ring_full_waits++;
+            std::this_thread::yield();
+        }
+        stats_.events++;
+    }
+
+    void run(ClientRunState& st, bool pin) {
+        if (pin) pin_current_thread(id_ + 1);
+        stats_ = ClientThreadStats();
+        double cpu_start = thread_cpu_seconds();
+        auto wall_start = SseClock::now();
+
+        std::vector<InflightRequest> inflight(pool_.size());
+        CURLM* multi = pool_.multi();
+
+        while (true) {
+            size_t n = st.limit.load(std::memory_order_relaxed);
+            while (pool_.in_use() < active_slots_) {
+                size_t i = st.next.load(std::memory_order_relaxed);
+                if (i >= n || st.due(i) > SseClock::now()) break;
+                if (!st.next.compare_exchange_weak(i, i + 1, std::memory_order_relaxed)) continue;
+                start_request(st, inflight, static_cast<uint32_t>(i));
+            }
+            if (pool_.in_use() == 0 && (active_slots_ == 0 || st.next.load(std::memory_order_relaxed) >= n)) break;
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+
+            CURLMsg* msg;
+            int queued = 0;
+            while ((msg = curl_multi_info_read(multi, &queued)) != nullptr) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                InflightRequest* req = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&req));
+                finish_request(st, req, msg->data.result);
+            }
+
+            // Wake up in time for the next scheduled arrival if a slot is free.
+            int timeout_ms = 100;
+            size_t next = st.next.load(std::memory_order_relaxed);
+            if (next < n && pool_.in_use() < active_slots_) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(st.due(next) - SseClock::now()).count();
+                timeout_ms = static_cast<int>(std::max<long long>(0, std::min<long long>(timeout_ms, wait)));
+            }
+            curl_multi_poll(multi, nullptr, 0, timeout_ms, nullptr);
+        }
+
+        stats_.wall_s = std::chrono::duration<double>(SseClock::now() - wall_start).count();
+        stats_.cpu_s = thread_cpu_seconds() - cpu_start;
+        st.workers_running.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    // The fields of one streamed chunk the client needs, pulled out in a
+    // single allocation-free SAX pass. Completions and /generate put token
+    // text in "text", chat in "delta.content" (or "reasoning_content").
+    // OpenAI servers stream a final `usage` object; SGLang's /generate
+    // carries running counts in every chunk's `meta_info`.
+    struct ChunkFields : JsonSaxHandler {
+        std::string_view key;
+        bool has_token = false;
+        int prompt_tokens = -1;
+        int completion_tokens = -1;
+
+        bool on_key(std::string_view raw, bool) {
+            key = raw;
+            return true;
+        }
+        bool on_string(std::string_view raw, bool) {
+            if (!raw.empty() && (key == "text" || key == "content" || key == "reasoning_content")) has_token = true;
+            return true;
+        }
+        bool on_integer(long long v) {
+            if (key == "completion_tokens") completion_tokens = static_cast<int>(v);
+            if (key == "prompt_tokens") prompt_tokens = static_cast<int>(v);
+            return true;
+        }
+    };
+
+    static void on_sse_data(void* ctx, std::string_view payload, SseClock::time_point recv_time) {
+        auto* req = static_cast<InflightRequest*>(ctx);
+        if (payload == "[DONE]") return;
+
+        ChunkFields f;
+        json_sax_parse(payload, f);             // a malformed chunk keeps what was read before the error
+        if (f.has_token) {
+            TimingEvent ev;
+            ev.t_ns = steady_ns(recv_time);
+            ev.request = req->index;
+            ev.kind = EVENT_TOKEN;
+            ev.output_len = f.completion_tokens;
+            req->shard->emit(ev);
+            req->chunks++;
+        }
+        if (f.completion_tokens >= 0) req->output_len = f.completion_tokens;
+        if (f.prompt_tokens >= 0) req->prompt_len = f.prompt_tokens;
+    }
+
+    static size_t on_write(char* ptr, size_t size, size_t nmemb, void* userdata) {
+        auto* req = static_cast<InflightRequest*>(userdata);
+        size_t n = size * nmemb;
+        SseClock::time_point now = SseClock::now();
+
+        if (!req->got_first_byte) {
+            req->got_first_byte = true;
+            TimingEvent ev;
+            ev.t_ns = steady_ns(now);
+            ev.request = req->index;
+            ev.kind = EVENT_FIRST_BYTE;
+            req->shard->emit(ev);
+        }
+        if (req->http_code == 0) {
+            curl_easy_getinfo(req->easy, CURLINFO_RESPONSE_CODE, &req->http_code);
+        }
+        if (req->http_code != 200) {
+            req->error_body.append(ptr, n);
+            return n;
+        }
+        req->sse.feed(ptr, n, now);
+        return n;
+    }
+
+    void start_request(ClientRunState& st, std::vector<InflightRequest>& inflight, uint32_t index) {
+        const LoadGenConfig& cfg = *st.cfg;
+        const PromptSpec& p = (*st.prompts)[index];
+        int slot = pool_.acquire();
+        InflightRequest& req = inflight[slot];
+        req.shard = this;
+        req.easy = pool_.handle(slot);
+        req.slot = slot;
+        req.index = index;
+        req.body = build_request_body(cfg, p);
+        req.sse.reset();
+        req.sse.set_handler(on_sse_data, &req);
+        req.http_code = 0;
+        req.error_body.clear();
+        req.got_first_byte = false;
+        req.chunks = 0;
+        req.prompt_len = p.prompt_len;
+        req.output_len = 0;
+
+        std::string url = slot_base_url(cfg, slot_base_ + slot) + request_path(cfg);
+        curl_easy_setopt(req.easy, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(req.easy, CURLOPT_POSTFIELDS, req.body.c_str());
+        curl_easy_setopt(req.easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(req.body.size()));
+        curl_easy_setopt(req.easy, CURLOPT_WRITEFUNCTION, on_write);
+        curl_easy_setopt(req.easy, CURLOPT_WRITEDATA, &req);
+        curl_easy_setopt(req.easy, CURLOPT_PRIVATE, &req);
+
+        TimingEvent ev;
+        ev.t_ns = steady_ns(SseClock::now());
+        ev.request = index;
+        ev.kind = EVENT_SEND;
+        ev.slot = static_cast<uint16_t>(slot_base_ + slot);
+        emit(ev);
+        curl_multi_add_handle(pool_.multi(), req.easy);
+    }
+
+    void finish_request(ClientRunState& st, InflightRequest* req, CURLcode code) {
+        TimingEvent ev;
+        ev.t_ns = steady_ns(SseClock::now());
+        ev.request = req->index;
+        ev.kind = EVENT_DONE;
+
+        std::string& error = st.errors[req->index];
+        if (code != CURLE_OK) {
+            error = curl_easy_strerror(code);
+        } else if (req->http_code != 200) {
+            error = "HTTP " + std::to_string(req->http_code) + ": " + req->error_body.substr(0, 512);
+        } else if (req->chunks == 0) {
+            error = "Never received a valid chunk to calculate TTFT";
+        } else {
+            ev.success = 1;
+        }
+        ev.prompt_len = req->prompt_len;
+        // Servers that do not stream usage: fall back to the number of token chunks.
+        ev.output_len = req->output_len > 0 ? req->output_len : req->chunks;
+
+        curl_multi_remove_handle(pool_.multi(), req->easy);
+        pool_.release(req->slot);
+        emit(ev);
+    }
+
+    int id_;
+    int slot_base_;                             // first client-wide slot id of this shard
+    int active_slots_;
+    ConnectionPool pool_;
+    SpscRing<TimingEvent> ring_;
+    ClientThreadStats stats_;
+};
+
+// ============================================
+// Client Front End
+// ============================================
+struct ClientUtilisation {
+    int threads = 0;
+    double worker_util_max = 0.0;
+    double worker_util_mean = 0.0;
+    double aggregator_util = 0.0;
+    long long events = 0;
+    long long ring_full_waits = 0;
+};
+
+class ShardedClient {
+public:
+    ShardedClient(int concurrency, int threads, bool pin) : pin_(pin) {
+        concurrency = std::max(1, concurrency);
+        threads = threads > 0 ? std::min(threads, concurrency) : auto_client_threads(concurrency);
+        int slot_base = 0;
+        for (int k = 0; k < threads; k++) {
+            int slots = concurrency / threads + (k < concurrency % threads ? 1 : 0);
+            shards_.push_back(std::unique_ptr<ClientShard>(new ClientShard(k, slot_base, slots, 1 << 16)));
+            slot_base += slots;
+        }
+        capacity_ = concurrency;
+        concurrency_ = concurrency;
+    }
+
+    int threads() const { return static_cast<int>(shards_.size()); }
+    int capacity() const { return capacity_; }
+    int concurrency() const { return concurrency_; }
+
+    // Caps in-flight requests below the capacity the client was built for,
+    // spread over the shards like the constructor spreads slots, so a sweep
+    // can run every CONC on one client and its warm connections.
+    void set_concurrency(int concurrency) {
+        concurrency_ = std::max(1, std::min(concurrency, capacity_));
+        const int threads = static_cast<int>(shards_.size());
+        for (int k = 0; k < threads; k++) {
+            shards_[k]->set_active_slots(concurrency_ / threads + (k < concurrency_ % threads ? 1 : 0));
+        }
+    }
+
+    // Threads with at least one active slot.
+    int active_threads() const {
+        int n = 0;
+        for (const auto& shard : shards_) n += shard->active_slots() > 0;
+        return n;
+    }
+
+    // Issues prompt i once `send_offsets_s[i]` seconds have elapsed since the
+    // start of the run and a slot is free; prompts past the end of the
+    // schedule are not sent. With all offsets zero this is the closed loop of
+    // request rate = inf. Returns results in prompt order; `journal`, when
+    // given, gets each one as soon as it completes. With cfg.adaptive the
+    // run stops claiming prompts once the metrics converge, and only the
+    // prompts sent are returned.
+    std::vector<RequestResult> run(const LoadGenConfig& cfg, const std::vector<PromptSpec>& prompts,
+                                   const std::vector<double>& send_offsets_s, double* duration_s,
+                                   ResultJournal* journal = nullptr) {
+        const size_t n = std::min(prompts.size(), send_offsets_s.size());
+        std::vector<RequestResult> results(n);
+        ClientRunState st;
+        st.cfg = &cfg;
+        st.prompts = &prompts;
+        st.send_offsets_s = &send_offsets_s;
+        st.open_loop = arrival_is_open_loop(cfg.arrival);
+        st.journal = journal;
+        st.errors.assign(n, std::string());
+        st.limit.store(n);
+        st.workers_running.store(static_cast<int>(shards_.size()));
+        st.start = SseClock::now();
+
+        std::vector<std::thread> workers;
+        for (auto& shard : shards_) {
+            ClientShard* s = shard.get();
+            workers.emplace_back([s, &st, this]() { s->run(st, pin_); });
+        }
+
+        double agg_cpu_start = 0.0;
+        double agg_cpu = 0.0;
+        std::thread aggregator([&]() {
+            if (pin_) pin_current_thread(0);
+            agg_cpu_start = thread_cpu_seconds();
+            aggregate(st, results);
+            agg_cpu = thread_cpu_seconds() - agg_cpu_start;
+        });
+
+        for (auto& w : workers) w.join();
+        aggregator.join();
+        double wall = std::chrono::duration<double>(SseClock::now() - st.start).count();
+        if (duration_s) *duration_s = wall;
+        results.resize(std::min(n, st.next.load()));
+
+        util_ = ClientUtilisation();
+        util_.threads = active_threads();
+        for (auto& shard : shards_) {
+            if (shard->active_slots() == 0) continue;
+            const ClientThreadStats& ts = shard->stats();
+            util_.worker_util_max = std::max(util_.worker_util_max, ts.utilisation());
+            util_.worker_util_mean += ts.utilisation() / util_.threads;
+            util_.events += ts.events;
+            util_.ring_full_waits += ts.ring_full_waits;
+        }
+        util_.aggregator_util = wall > 0 ? agg_cpu / wall : 0.0;
+        return results;
+    }
+
+    const ClientUtilisation& utilisation() const { return util_; }
+    // The adaptive stop rule's last check of the latest run.
+    const ConvergenceState& convergence() const { return convergence_; }
+
+    ConnectionStats connection_stats() const {
+        ConnectionStats merged;
+        for (const auto& shard : shards_) {
+            const ConnectionStats& s = shard->pool().stats();
+            merged.requests += s.requests;
+            merged.new_connections += s.new_connections;
+            merged.reused += s.reused;
+            merged.connect_ms.merge(s.connect_ms);
+        }
+        return merged;
+    }
+
+    void reset_connection_stats() {
+        for (auto& shard : shards_) shard->pool().reset_stats();
+    }
+
+private:
+    struct RequestTrack {
+        int64_t start_ns = 0;
+        int64_t last_ns = 0;
+        bool got_first_token = false;
+        int reported_tokens = 0;                // last running completion count a chunk carried
+    };
+
+    void aggregate(ClientRunState& st, std::vector<RequestResult>& results) {
+        std::vector<RequestTrack> track(results.size());
+        const int64_t run_start_ns = steady_ns(st.start);
+        const AdaptiveSampling& rule = st.cfg->adaptive;
+        const int check_every = std::max(1, st.cfg->max_concurrency / 4);
+        ConvergenceSamples samples;
+        std::mt19937 rng(rule.seed);
+        int unchecked = 0;
+        bool stopped = !rule.enabled;
+        convergence_ = ConvergenceState();
+        TimingEvent ev;
+        while (true) {
+            // Read the running count before draining so no event published
+            // before a worker exits can be missed.
+            bool workers_done = st.workers_running.load(std::memory_order_acquire) == 0;
+            size_t drained = 0;
+            for (auto& shard : shards_) {
+                while (shard->ring().try_pop(ev)) {
+                    apply_event(st, ev, run_start_ns, track[ev.request], results[ev.request]);
+                    drained++;
+                    if (stopped || ev.kind != EVENT_DONE || !results[ev.request].success) continue;
+                    const RequestResult& r = results[ev.request];
+                    if (r.output_len > 1) samples.tpot_ms.push_back((r.e2el_ms - r.ttft_ms) / (r.output_len - 1));
+                    samples.e2el_ms.push_back(r.e2el_ms);
+                    samples.tokens.push_back(r.prompt_len + r.output_len);
+                    if (++unchecked < check_every || static_cast<int>(samples.e2el_ms.size()) < rule.min_prompts) continue;
+                    unchecked = 0;
+                    convergence_ = check_convergence(samples, rule, rng, convergence_.checks);
+                    if (convergence_.converged) {
+                        st.limit.store(st.next.load());
+                        stopped = true;
+                    }
+                }
+            }
+            if (drained == 0) {
+                if (workers_done) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    static void apply_event(ClientRunState& st, const TimingEvent& ev, int64_t run_start_ns, RequestTrack& t,
+                            RequestResult& r) {
+        switch (ev.kind) {
+            case EVENT_SEND: {
+                t.start_ns = ev.t_ns;
+                t.last_ns = ev.t_ns;
+                const PromptSpec& p = (*st.prompts)[ev.request];
+                r.prompt_len = p.prompt_len;
+                r.itl_ms.reserve(p.output_len);
+                r.chunk_tokens.reserve(p.output_len);
+                r.send_time_s = (ev.t_ns - run_start_ns) / 1e9;
+                if (st.open_loop) {
+                    r.intended_start_s = (*st.send_offsets_s)[ev.request];
+                    r.send_lag_ms = r.send_time_s * 1000.0 - r.intended_start_s * 1000.0;
+                } else {
+                    // Closed loop: due when its slot freed up, i.e. now.
+                    r.intended_start_s = r.send_time_s;
+                    r.send_lag_ms = 0.0;
+                }
+                r.slot = ev.slot;
+                break;
+            }
+            case EVENT_FIRST_BYTE:
+                r.first_byte_ms = (ev.t_ns - t.start_ns) / 1e6;
+                break;
+            case EVENT_TOKEN:
+                if (!t.got_first_token) {
+                    t.got_first_token = true;
+                    r.ttft_ms = (ev.t_ns - t.start_ns) / 1e6;
+                } else {
+                    r.itl_ms.push_back((ev.t_ns - t.last_ns) / 1e6);
+                }
+                t.last_ns = ev.t_ns;
+                if (ev.output_len >= 0) {
+                    r.chunk_tokens.push_back(ev.output_len - t.reported_tokens);
+                    t.reported_tokens = ev.output_len;
+                } else {
+                    r.chunk_tokens.push_back(-1);
+                }
+                break;
+            case EVENT_DONE:
+                r.success = ev.success != 0;
+                r.prompt_len = ev.prompt_len;
+                r.output_len = ev.output_len;
+                fill_unreported_chunk_tokens(r, t.reported_tokens);
+                if (r.success) {
+                    r.e2el_ms = (ev.t_ns - t.start_ns) / 1e6;
+                } else {
+                    r.error = std::move(st.errors[ev.request]);
+                }
+                if (st.journal) st.journal->append(ev.request, r);
+                break;
+        }
+    }
+
+    // Chunks that carried no running count (OpenAI servers only stream usage
+    // at the end) share the tokens not accounted for by the ones that did.
+    static void fill_unreported_chunk_tokens(RequestResult& r, int reported) {
+        int unreported = 0;
+        for (int32_t n : r.chunk_tokens) unreported += n < 0;
+        if (unreported == 0) return;
+        int rest = std::max(0, r.output_len - reported);
+        int share = rest / unreported, extra = rest % unreported;
+        for (int32_t& n : r.chunk_tokens) {
+            if (n >= 0) continue;
+            n = share + (extra > 0 ? 1 : 0);
+            extra--;
+        }
+    }
+
+    bool pin_;
+    std::vector<std::unique_ptr<ClientShard>> shards_;
+    int capacity_ = 0;
+    int concurrency_ = 0;
+    ClientUtilisation util_;
+    ConvergenceState convergence_;
+};
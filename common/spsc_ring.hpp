@@ -0,0 +1,63 @@
+// ============================================
+// Single-Producer / Single-Consumer Lock-Free Ring
+// ============================================
+// Bounded ring buffer for trivially copyable records. Exactly one thread may
+// push and exactly one (other) thread may pop. Head and tail live on separate
+// cache lines and each side caches the other's index, so the steady state
+// costs one relaxed load and one release store per operation.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing holds trivially copyable records");
+
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscRing(size_t capacity = 65536) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        buf_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    bool try_push(const T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) return false;
+        }
+        buf_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        item = buf_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::vector<T> buf_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;                     // consumer's view of tail
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;                     // producer's view of head
+};
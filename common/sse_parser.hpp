@@ -0,0 +1,82 @@
+// ============================================
+// Zero-Copy Server-Sent-Events Parser
+// ============================================
+// Parses the `text/event-stream` bodies of /v1/completions and
+// /v1/chat/completions straight out of the socket receive buffer. Every
+// `data:` line is handed to the handler as a string_view into that buffer,
+// stamped with the monotonic time the chunk carrying it was received.
+//
+// The only copy happens when a line straddles two receive buffers; that tail
+// goes into a carry buffer whose capacity is reused, so a warmed-up parser
+// does not allocate per event.
+//
+// OpenAI-compatible servers send one `data:` line per event, so each data
+// line is dispatched as soon as it is complete instead of waiting for the
+// blank line that closes the event. `event:`, `id:`, `retry:` and comment
+// lines are ignored.
+
+#pragma once
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+using SseClock = std::chrono::steady_clock;
+
+class SseParser {
+public:
+    typedef void (*DataHandler)(void* ctx, std::string_view data, SseClock::time_point recv_time);
+
+    SseParser(DataHandler handler = nullptr, void* ctx = nullptr) : handler_(handler), ctx_(ctx) {
+        carry_.reserve(4096);
+    }
+
+    void set_handler(DataHandler handler, void* ctx) {
+        handler_ = handler;
+        ctx_ = ctx;
+    }
+
+    // Drops any partial line; keeps the carry buffer's capacity.
+    void reset() {
+        carry_.clear();
+        events_ = 0;
+    }
+
+    void feed(const char* buf, size_t len, SseClock::time_point recv_time) {
+        const char* p = buf;
+        const char* end = buf + len;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (nl == nullptr) {
+                carry_.append(p, end - p);
+                return;
+            }
+            if (!carry_.empty()) {
+                carry_.append(p, nl - p);
+                on_line(std::string_view(carry_), recv_time);
+                carry_.clear();
+            } else {
+                on_line(std::string_view(p, nl - p), recv_time);
+            }
+            p = nl + 1;
+        }
+    }
+
+    size_t events() const { return events_; }
+
+private:
+    void on_line(std::string_view line, SseClock::time_point recv_time) {
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.size() < 5 || line.compare(0, 5, "data:") != 0) return;
+        line.remove_prefix(5);
+        if (!line.empty() && line.front() == ' ') line.remove_prefix(1);
+        events_++;
+        if (handler_) handler_(ctx_, line, recv_time);
+    }
+
+    DataHandler handler_;
+    void* ctx_;
+    std::string carry_;
+    size_t events_ = 0;
+};
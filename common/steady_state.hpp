@@ -0,0 +1,164 @@
+// ============================================
+// Steady-State Measurement Window
+// ============================================
+// A closed-loop run ramps up while the first CONC requests are all in
+// prefill, and drains at the end while fewer than CONC requests remain. Both
+// phases deflate throughput. This finds the steady window:
+//
+//   1. start no earlier than the moment in-flight concurrency first reaches
+//      CONC, end no later than the moment it first drops below CONC after the
+//      last request was sent (start of the drain tail);
+//   2. inside that span, bin output-token arrivals over time and move the
+//      start forward to the first bin from which the mean of the next
+//      `STEADY_STABLE_BINS` bins is within `tolerance` of the median bin rate.
+//
+// Latency metrics over the window use the requests sent and finished inside
+// it; throughput counts the tokens that arrived and the requests that
+// completed inside it.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "workload.hpp"
+
+struct SteadyStateSummary {
+    bool detected = false;
+    double window_start_s = 0.0;
+    double window_end_s = 0.0;
+    double mean_concurrency = 0.0;
+    int requests = 0;
+    double request_throughput = 0.0;
+    double output_throughput = 0.0;
+    double total_token_throughput = 0.0;
+    double median_ttft_ms = 0.0, p99_ttft_ms = 0.0;
+    double median_tpot_ms = 0.0, p99_tpot_ms = 0.0;
+    double median_itl_ms = 0.0, p99_itl_ms = 0.0;
+    double median_e2el_ms = 0.0, p99_e2el_ms = 0.0;
+
+    double duration_s() const { return window_end_s - window_start_s; }
+};
+
+static const int STEADY_STABLE_BINS = 3;
+
+inline SteadyStateSummary detect_steady_state(const std::vector<RequestResult>& requests, int concurrency,
+                                              double tolerance = 0.15) {
+    SteadyStateSummary s;
+
+    // In-flight timeline from send/done edges.
+    std::vector<std::pair<double, int>> edges;
+    double last_send = 0.0;
+    for (const auto& r : requests) {
+        if (!r.success) continue;
+        edges.push_back({r.send_time_s, +1});
+        edges.push_back({r.send_time_s + r.e2el_ms / 1000.0, -1});
+        last_send = std::max(last_send, r.send_time_s);
+    }
+    if (edges.empty()) return s;
+    // Completions before sends at the same instant, so a slot handed straight
+    // to the next request does not count as two in flight.
+    std::sort(edges.begin(), edges.end());
+
+    int target = std::min<int>(concurrency, static_cast<int>(edges.size() / 2));
+    int inflight = 0;
+    double span_start = -1.0, span_end = -1.0;
+    for (const auto& e : edges) {
+        inflight += e.second;
+        if (span_start < 0 && inflight >= target) span_start = e.first;
+        if (span_start >= 0 && e.first >= last_send && inflight < target) {
+            span_end = e.first;
+            break;
+        }
+    }
+    if (span_start < 0 || span_end <= span_start) return s;
+
+    // Output-token arrivals binned over the span. A chunk may carry several
+    // tokens (MTP), so each chunk is credited output_len / chunks tokens.
+    // Bins are at least half a request long so lockstep decode waves at low
+    // CONC do not read as throughput swings.
+    std::vector<double> e2els;
+    for (const auto& r : requests) {
+        if (r.success) e2els.push_back(r.e2el_ms / 1000.0);
+    }
+    double span = span_end - span_start;
+    double bin_s = std::max(span / 40.0, loadgen_percentile(e2els, 50) / 2.0);
+    int nbins = std::max(1, static_cast<int>(span / bin_s));
+    std::vector<double> bins(nbins, 0.0);
+    for (const auto& r : requests) {
+        if (!r.success) continue;
+        double per_chunk = static_cast<double>(r.output_len) / (r.itl_ms.size() + 1);
+        double t = r.send_time_s + r.ttft_ms / 1000.0;
+        for (size_t j = 0; j <= r.itl_ms.size(); j++) {
+            if (j > 0) t += r.itl_ms[j - 1] / 1000.0;
+            int b = static_cast<int>((t - span_start) / bin_s);
+            if (t >= span_start && b < nbins) bins[b] += per_chunk;
+        }
+    }
+
+    std::vector<double> sorted_bins(bins);
+    std::sort(sorted_bins.begin(), sorted_bins.end());
+    double ref = sorted_bins[sorted_bins.size() / 2];
+    int first_stable = -1;
+    for (int i = 0; ref > 0 && i + STEADY_STABLE_BINS <= nbins; i++) {
+        double rolling = 0.0;
+        for (int k = i; k < i + STEADY_STABLE_BINS; k++) rolling += bins[k];
+        rolling /= STEADY_STABLE_BINS;
+        if (std::fabs(rolling - ref) <= tolerance * ref) {
+            first_stable = i;
+            break;
+        }
+    }
+    if (first_stable < 0) return s;
+
+    s.detected = true;
+    s.window_start_s = span_start + first_stable * bin_s;
+    s.window_end_s = span_end;
+    double window = s.duration_s();
+
+    // Metrics over the window.
+    std::vector<double> ttfts, tpots, itls;
+    e2els.clear();
+    long long in_tokens = 0;
+    double out_tokens = 0.0;
+    double busy_s = 0.0;
+    int completions = 0;
+    for (const auto& r : requests) {
+        if (!r.success) continue;
+        double send = r.send_time_s;
+        double done = send + r.e2el_ms / 1000.0;
+        double first_token = send + r.ttft_ms / 1000.0;
+        busy_s += std::max(0.0, std::min(done, s.window_end_s) - std::max(send, s.window_start_s));
+        if (first_token >= s.window_start_s && first_token < s.window_end_s) in_tokens += r.prompt_len;
+        if (done >= s.window_start_s && done <= s.window_end_s) completions++;
+
+        double per_chunk = static_cast<double>(r.output_len) / (r.itl_ms.size() + 1);
+        double t = first_token;
+        for (size_t j = 0; j <= r.itl_ms.size(); j++) {
+            if (j > 0) t += r.itl_ms[j - 1] / 1000.0;
+            if (t >= s.window_start_s && t < s.window_end_s) out_tokens += per_chunk;
+        }
+
+        if (send < s.window_start_s || done > s.window_end_s) continue;
+        s.requests++;
+        ttfts.push_back(r.ttft_ms);
+        e2els.push_back(r.e2el_ms);
+        if (r.output_len > 1) tpots.push_back((r.e2el_ms - r.ttft_ms) / (r.output_len - 1));
+        itls.insert(itls.end(), r.itl_ms.begin(), r.itl_ms.end());
+    }
+
+    s.mean_concurrency = busy_s / window;
+    s.request_throughput = completions / window;
+    s.output_throughput = out_tokens / window;
+    s.total_token_throughput = (in_tokens + out_tokens) / window;
+    s.median_ttft_ms = loadgen_percentile(ttfts, 50);
+    s.p99_ttft_ms = loadgen_percentile(ttfts, 99);
+    s.median_tpot_ms = loadgen_percentile(tpots, 50);
+    s.p99_tpot_ms = loadgen_percentile(tpots, 99);
+    s.median_itl_ms = loadgen_percentile(itls, 50);
+    s.p99_itl_ms = loadgen_percentile(itls, 99);
+    s.median_e2el_ms = loadgen_percentile(e2els, 50);
+    s.p99_e2el_ms = loadgen_percentile(e2els, 99);
+    return s;
+}
@@ -0,0 +1,189 @@
+// ============================================
+// Pareto Frontier and SVG Scatter Charts
+// ============================================
+// Just enough plotting for the README's required charts (throughput per GPU
+// against E2E latency and against interactivity): linear axes from zero with
+// round tick steps, one or more point series, and an optional line through a
+// series (the Pareto frontier). The output is a standalone SVG any browser
+// opens.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct ChartPoint {
+    double x = 0.0;
+    double y = 0.0;
+    std::string label;
+};
+
+struct ChartSeries {
+    std::string name;
+    std::string color = "#d62728";
+    std::vector<ChartPoint> points;
+    bool connect = false;                       // draw a line through the points in x order
+    bool hollow = false;                        // outlined markers (targets) instead of filled
+};
+
+struct ChartSpec {
+    std::string title;
+    std::string x_label;
+    std::string y_label;
+    std::vector<ChartSeries> series;
+};
+
+// Indices of the points no other point beats on both axes. `*_higher` says
+// which direction is better on each axis.
+inline std::vector<size_t> pareto_frontier(const std::vector<ChartPoint>& pts, bool x_higher, bool y_higher) {
+    auto better_eq = [](double a, double b, bool higher) { return higher ? a >= b : a <= b; };
+    std::vector<size_t> front;
+    for (size_t i = 0; i < pts.size(); i++) {
+        bool dominated = false;
+        for (size_t j = 0; j < pts.size() && !dominated; j++) {
+            if (j == i) continue;
+            bool no_worse = better_eq(pts[j].x, pts[i].x, x_higher) && better_eq(pts[j].y, pts[i].y, y_higher);
+            bool better = pts[j].x != pts[i].x || pts[j].y != pts[i].y;
+            dominated = no_worse && better;
+        }
+        if (!dominated) front.push_back(i);
+    }
+    std::sort(front.begin(), front.end(), [&](size_t a, size_t b) { return pts[a].x < pts[b].x; });
+    return front;
+}
+
+// 1, 2 or 5 times a power of ten, giving about `ticks` intervals over [0, max].
+inline double chart_tick_step(double max, int ticks = 5) {
+    if (max <= 0) return 1.0;
+    double raw = max / ticks;
+    double mag = std::pow(10.0, std::floor(std::log10(raw)));
+    double norm = raw / mag;
+    double step = norm <= 1 ? 1 : norm <= 2 ? 2 : norm <= 5 ? 5 : 10;
+    return step * mag;
+}
+
+inline std::string svg_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += c;
+        }
+    }
+    return out;
+}
+
+inline std::string format_tick(double v) {
+    char buf[32];
+    if (v != 0 && (std::fabs(v) >= 1e6 || std::fabs(v) < 1e-2)) {
+        snprintf(buf, sizeof(buf), "%.0e", v);
+    } else {
+        snprintf(buf, sizeof(buf), "%g", v);
+    }
+    return buf;
+}
+
+inline std::string render_svg_chart(const ChartSpec& spec) {
+    const double width = 720, height = 480;
+    const double left = 80, right = 170, top = 48, bottom = 64;
+    const double plot_w = width - left - right, plot_h = height - top - bottom;
+
+    double x_max = 0, y_max = 0;
+    for (const auto& s : spec.series) {
+        for (const auto& p : s.points) {
+            x_max = std::max(x_max, p.x);
+            y_max = std::max(y_max, p.y);
+        }
+    }
+    double x_step = chart_tick_step(x_max * 1.05), y_step = chart_tick_step(y_max * 1.05);
+    x_max = std::max(x_step, std::ceil(x_max * 1.05 / x_step) * x_step);
+    y_max = std::max(y_step, std::ceil(y_max * 1.05 / y_step) * y_step);
+    auto px = [&](double x) { return left + x / x_max * plot_w; };
+    auto py = [&](double y) { return top + plot_h - y / y_max * plot_h; };
+
+    std::string svg;
+    char buf[512];
+    auto add = [&](const char* fmt, auto... args) {
+        snprintf(buf, sizeof(buf), fmt, args...);
+        svg += buf;
+    };
+
+    add("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" viewBox=\"0 0 %.0f %.0f\" "
+        "font-family=\"sans-serif\" font-size=\"12\">\n", width, height, width, height);
+    add("<rect width=\"%.0f\" height=\"%.0f\" fill=\"white\"/>\n", width, height);
+    add("<text x=\"%.1f\" y=\"28\" text-anchor=\"middle\" font-size=\"15\">%s</text>\n", left + plot_w / 2,
+        svg_escape(spec.title).c_str());
+
+    // Grid and tick labels.
+    for (double x = 0; x <= x_max + x_step / 2; x += x_step) {
+        add("<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#e5e5e5\"/>\n", px(x), top, px(x), top + plot_h);
+        add("<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">%s</text>\n", px(x), top + plot_h + 18,
+            format_tick(x).c_str());
+    }
+    for (double y = 0; y <= y_max + y_step / 2; y += y_step) {
+        add("<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"#e5e5e5\"/>\n", left, py(y), left + plot_w, py(y));
+        add("<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"end\">%s</text>\n", left - 8, py(y) + 4, format_tick(y).c_str());
+    }
+    add("<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" fill=\"none\" stroke=\"#444\"/>\n", left, top, plot_w,
+        plot_h);
+    add("<text x=\"%.1f\" y=\"%.1f\" text-anchor=\"middle\">%s</text>\n", left + plot_w / 2, height - 20,
+        svg_escape(spec.x_label).c_str());
+    add("<text transform=\"translate(22 %.1f) rotate(-90)\" text-anchor=\"middle\">%s</text>\n", top + plot_h / 2,
+        svg_escape(spec.y_label).c_str());
+
+    // Series, then the legend.
+    for (const auto& s : spec.series) {
+        std::string color = svg_escape(s.color);
+        if (s.connect && s.points.size() > 1) {
+            std::vector<ChartPoint> sorted(s.points);
+            std::sort(sorted.begin(), sorted.end(), [](const ChartPoint& a, const ChartPoint& b) { return a.x < b.x; });
+            svg += "<polyline fill=\"none\" stroke=\"" + color + "\" stroke-width=\"1.5\" points=\"";
+            for (const auto& p : sorted) add("%.1f,%.1f ", px(p.x), py(p.y));
+            svg += "\"/>\n";
+        }
+        for (const auto& p : s.points) {
+            if (s.hollow) {
+                add("<rect x=\"%.1f\" y=\"%.1f\" width=\"9\" height=\"9\" fill=\"white\" stroke=\"%s\" stroke-width=\"2\"/>\n",
+                    px(p.x) - 4.5, py(p.y) - 4.5, color.c_str());
+            } else {
+                add("<circle cx=\"%.1f\" cy=\"%.1f\" r=\"4.5\" fill=\"%s\"/>\n", px(p.x), py(p.y), color.c_str());
+            }
+            if (!p.label.empty()) {
+                add("<text x=\"%.1f\" y=\"%.1f\" fill=\"%s\">%s</text>\n", px(p.x) + 7, py(p.y) - 6, color.c_str(),
+                    svg_escape(p.label).c_str());
+            }
+        }
+    }
+    double ly = top + 8;
+    for (const auto& s : spec.series) {
+        std::string color = svg_escape(s.color);
+        double lx = left + plot_w + 16;
+        if (s.hollow) {
+            add("<rect x=\"%.1f\" y=\"%.1f\" width=\"9\" height=\"9\" fill=\"white\" stroke=\"%s\" stroke-width=\"2\"/>\n",
+                lx, ly - 4.5, color.c_str());
+        } else if (s.connect) {
+            add("<line x1=\"%.1f\" y1=\"%.1f\" x2=\"%.1f\" y2=\"%.1f\" stroke=\"%s\" stroke-width=\"1.5\"/>\n", lx - 4, ly,
+                lx + 13, ly, color.c_str());
+        } else {
+            add("<circle cx=\"%.1f\" cy=\"%.1f\" r=\"4.5\" fill=\"%s\"/>\n", lx + 4.5, ly, color.c_str());
+        }
+        add("<text x=\"%.1f\" y=\"%.1f\">%s</text>\n", lx + 20, ly + 4, svg_escape(s.name).c_str());
+        ly += 20;
+    }
+    svg += "</svg>\n";
+    return svg;
+}
+
+inline bool write_svg_chart(const std::string& path, const ChartSpec& spec) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << render_svg_chart(spec);
+    return out.good();
+}
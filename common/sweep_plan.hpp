@@ -0,0 +1,135 @@
+// ============================================
+// Sweep Planner
+// ============================================
+// Expands an ISL x OSL x CONC matrix into run points, estimates each point's
+// runtime from earlier results and orders the runs:
+//
+//   - points of one (ISL, OSL) shape run back to back, CONC ascending, so the
+//     server's compiled graphs and the client's connection pools carry over
+//     from point to point;
+//   - shapes that fit the server's max_model_len run first; the rest, which
+//     need the server relaunched with a longer context, come last in
+//     ascending context order, so one relaunch (at the largest) covers them.
+//
+// Runtime: a closed loop of N prompts at CONC takes about ceil(N / CONC)
+// request latencies. The latency comes from the closest earlier result
+// (same point, else same shape at the nearest CONC, else the nearest shape
+// scaled by OSL), or a rough decode/prefill guess without any history.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct PastRun {
+    int isl = 0;
+    int osl = 0;
+    int conc = 0;
+    int num_prompts = 0;
+    double duration_s = 0.0;
+    double median_e2el_ms = 0.0;
+};
+
+struct SweepPoint {
+    int isl = 0;
+    int osl = 0;
+    int conc = 0;
+    int num_prompts = 0;
+    double est_seconds = 0.0;
+    std::string est_basis;                      // where the estimate came from
+    bool leaderboard = false;                   // part of the leaderboard subset
+    bool exceeds_context = false;               // isl + osl > the server's max_model_len
+    bool done = false;                          // kept from the batch being resumed
+};
+
+// Without history: ~20 ms per output token and ~10k prompt tokens/s prefill.
+static const double SWEEP_GUESS_TPOT_S = 0.020;
+static const double SWEEP_GUESS_PREFILL_TOK_S = 10000.0;
+
+inline double sweep_waves(int num_prompts, int conc) {
+    return std::ceil(static_cast<double>(num_prompts) / std::max(1, conc));
+}
+
+inline void estimate_sweep_point(SweepPoint& p, const std::vector<PastRun>& history) {
+    const PastRun* best = nullptr;
+    double best_dist = 0;
+    for (const PastRun& h : history) {
+        if (h.duration_s <= 0 || h.conc <= 0 || h.isl <= 0 || h.osl <= 0) continue;
+        double d = std::fabs(std::log2(static_cast<double>(h.conc) / p.conc)) +
+                   4 * (std::fabs(std::log2(static_cast<double>(h.isl) / p.isl)) +
+                        std::fabs(std::log2(static_cast<double>(h.osl) / p.osl)));
+        if (!best || d < best_dist) {
+            best = &h;
+            best_dist = d;
+        }
+    }
+    if (!best) {
+        double e2e_s = p.osl * SWEEP_GUESS_TPOT_S + p.isl / SWEEP_GUESS_PREFILL_TOK_S;
+        p.est_seconds = sweep_waves(p.num_prompts, p.conc) * e2e_s;
+        p.est_basis = "guess";
+        return;
+    }
+    if (best_dist == 0) {
+        p.est_seconds = best->duration_s * p.num_prompts / std::max(1, best->num_prompts);
+        p.est_basis = "same point";
+        return;
+    }
+    // Per-request latency of the neighbour, over the whole run when the
+    // median is missing, scaled by OSL (decode dominates).
+    double e2e_s = best->median_e2el_ms > 0 ? best->median_e2el_ms / 1000.0
+                                            : best->duration_s / sweep_waves(best->num_prompts, best->conc);
+    e2e_s *= static_cast<double>(p.osl) / best->osl;
+    p.est_seconds = sweep_waves(p.num_prompts, p.conc) * e2e_s;
+    p.est_basis = "ISL=" + std::to_string(best->isl) + " OSL=" + std::to_string(best->osl) +
+                  " CONC=" + std::to_string(best->conc);
+}
+
+// `max_model_len` <= 0 means unknown: nothing is flagged.
+inline std::vector<SweepPoint> plan_sweep(const std::vector<int>& isls, const std::vector<int>& osls,
+                                          const std::vector<int>& concs, int prompts_per_conc,
+                                          const std::vector<PastRun>& history, int max_model_len) {
+    std::vector<SweepPoint> plan;
+    for (int isl : isls) {
+        for (int osl : osls) {
+            for (int conc : concs) {
+                SweepPoint p;
+                p.isl = isl;
+                p.osl = osl;
+                p.conc = conc;
+                p.num_prompts = conc * prompts_per_conc;
+                p.exceeds_context = max_model_len > 0 && isl + osl > max_model_len;
+                estimate_sweep_point(p, history);
+                plan.push_back(p);
+            }
+        }
+    }
+    std::stable_sort(plan.begin(), plan.end(), [](const SweepPoint& a, const SweepPoint& b) {
+        if (a.exceeds_context != b.exceeds_context) return !a.exceeds_context;
+        if (a.exceeds_context && a.isl + a.osl != b.isl + b.osl) return a.isl + a.osl < b.isl + b.osl;
+        if (a.isl != b.isl) return a.isl < b.isl;
+        if (a.osl != b.osl) return a.osl < b.osl;
+        return a.conc < b.conc;
+    });
+    plan.erase(std::unique(plan.begin(), plan.end(),
+                           [](const SweepPoint& a, const SweepPoint& b) {
+                               return a.isl == b.isl && a.osl == b.osl && a.conc == b.conc;
+                           }),
+               plan.end());
+    return plan;
+}
+
+inline std::string format_duration(double seconds) {
+    long long s = static_cast<long long>(seconds + 0.5);
+    char buf[32];
+    if (s >= 3600) {
+        snprintf(buf, sizeof(buf), "%lldh%02lldm", s / 3600, (s % 3600) / 60);
+    } else if (s >= 60) {
+        snprintf(buf, sizeof(buf), "%lldm%02llds", s / 60, s % 60);
+    } else {
+        snprintf(buf, sizeof(buf), "%llds", s);
+    }
+    return buf;
+}
@@ -0,0 +1,140 @@
+// ============================================
+// Batch Resume Test
+// ============================================
+// Resumes a batch whose every point already passed, from a working directory
+// that is not the binary's, by absolute and by relative path. Nothing is
+// rerun, so no server is needed: the kept points must be found, hashed and
+// read back from the batch directory, never from the cwd.
+
+#include "../track_engine.hpp"
+#include "check.hpp"
+
+struct Profile : TrackProfile<GptOssTrack1, VllmBackend> {};
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// A batch whose every point passed, with result files and hashes in place.
+static BatchManifest write_passed_batch(const std::string& dir, int isl, int osl, const std::vector<int>& concs) {
+    BatchManifest manifest;
+    manifest.model = "mock";
+    manifest.mode = "perf";
+    manifest.created = "test";
+    manifest.isls = {isl};
+    manifest.osls = {osl};
+    manifest.concs = concs;
+    for (int conc : concs) {
+        ManifestPoint mp;
+        mp.isl = isl;
+        mp.osl = osl;
+        mp.conc = conc;
+        mp.status = "passed";
+        mp.result_file = "result_isl" + std::to_string(isl) + "_osl" + std::to_string(osl) + "_conc" +
+                         std::to_string(conc) + ".json";
+        std::ofstream(dir + "/" + mp.result_file)
+            << "{\"benchmark_args\":{\"random_input_len\":" << isl << ",\"random_output_len\":" << osl
+            << ",\"max_concurrency\":" << conc << ",\"num_prompts\":" << conc * 10
+            << "},\"benchmark_duration\":1.5,\"median_e2el_ms\":50,"
+            << "\"tput_per_gpu\":" << conc * 100 << ",\"interactivity\":2000}";
+        mp.result_hash = track::result_file_hash(dir + "/" + mp.result_file);
+        CHECK(!mp.result_hash.empty());
+        manifest.points.push_back(mp);
+    }
+    CHECK(write_batch_manifest(dir + "/" + BATCH_MANIFEST_FILE, manifest));
+    return manifest;
+}
+
+// run_multi_conc_mode with its console output captured.
+static int run_captured(const track::Config& cfg, std::string& output) {
+    std::stringstream captured;
+    std::streambuf* old = std::cout.rdbuf(captured.rdbuf());
+    int rc = track::run_multi_conc_mode<Profile>(cfg);
+    std::cout.rdbuf(old);
+    output = captured.str();
+    return rc;
+}
+
+int main() {
+    char base_template[] = "/tmp/batch_resume_test.XXXXXX";
+    std::string base = mkdtemp(base_template);
+    std::string script_dir = base + "/bin";
+    std::string batch_dir = script_dir + "/batch_isl100_osl30_test";
+    std::string elsewhere = base + "/elsewhere";
+    CHECK(track::create_directory(script_dir));
+    CHECK(track::create_directory(batch_dir));
+    CHECK(track::create_directory(elsewhere));
+
+    BatchManifest manifest = write_passed_batch(batch_dir, 100, 30, {2, 4});
+
+    CHECK(chdir(elsewhere.c_str()) == 0);
+    for (const std::string& resume : {batch_dir, std::string("../bin/batch_isl100_osl30_test/")}) {
+        track::Config cfg;
+        cfg.mode = "perf";
+        cfg.model = "mock";
+        cfg.port = 1;                       // nothing listens; every point is kept
+        cfg.script_dir = script_dir;
+        cfg.resume_dir = resume;
+        CHECK(track::run_multi_conc_mode<Profile>(cfg) == 0);
+
+        std::string summary = read_file(batch_dir + "/summary.txt");
+        CHECK(summary.find("CONC=2: PASSED (kept") != std::string::npos);
+        CHECK(summary.find("CONC=4: PASSED (kept") != std::string::npos);
+        CHECK(summary.find("(kept from the resumed batch)") != std::string::npos);  // no finished_at here
+        CHECK(summary.find("kept from )") == std::string::npos);
+        CHECK(summary.find("Passed: 2") != std::string::npos);
+    }
+    BatchManifest resumed;
+    CHECK(read_batch_manifest(batch_dir + "/" + BATCH_MANIFEST_FILE, resumed));
+    CHECK(resumed.resumed.size() == 2);
+    CHECK(!track::file_exists(elsewhere + "/summary.txt"));
+
+    // A changed result file is no longer kept.
+    std::ofstream(batch_dir + "/" + manifest.points[0].result_file, std::ios::app) << " ";
+    CHECK(!track::manifest_point_kept(batch_dir, resumed.points[0]));
+    CHECK(track::manifest_point_kept(batch_dir, resumed.points[1]));
+
+    // A resumed submit only sends what the first run did not get accepted.
+    std::string lb_batch = script_dir + "/batch_isl8192_osl1024_test";
+    CHECK(track::create_directory(lb_batch));
+    BatchManifest lb_manifest = write_passed_batch(lb_batch, 8192, 1024, {4, 32, 128});
+    lb_manifest.points[0].event_id = "evt4";
+    lb_manifest.points[1].event_id = "evt32";
+    CHECK(write_batch_manifest(lb_batch + "/" + BATCH_MANIFEST_FILE, lb_manifest));
+    track::Config submit;
+    submit.mode = "submit";
+    submit.team_name = "test";
+    submit.model = "mock";
+    submit.port = 1;
+    submit.script_dir = script_dir;
+    submit.resume_dir = lb_batch;
+    submit.lb_url_override = "http://127.0.0.1:1";  // refuses: the one submission left fails
+    std::string output;
+    CHECK(run_captured(submit, output) != 0);
+    CHECK(output.find("CONC=4 was already submitted (event evt4)") != std::string::npos);
+    CHECK(output.find("CONC=32 was already submitted (event evt32)") != std::string::npos);
+    CHECK(output.find("Configuration: ISL=8192, OSL=1024, CONC=128") != std::string::npos);
+    CHECK(output.find("Configuration: ISL=8192, OSL=1024, CONC=4") == std::string::npos);
+    BatchManifest after;
+    CHECK(read_batch_manifest(lb_batch + "/" + BATCH_MANIFEST_FILE, after));
+    CHECK(after.points[0].event_id == "evt4" && after.points[2].event_id.empty());
+
+    after.points[2].event_id = "evt128";
+    CHECK(write_batch_manifest(lb_batch + "/" + BATCH_MANIFEST_FILE, after));
+    CHECK(run_captured(submit, output) == 0);
+    CHECK(output.find("Submitting results to leaderboard") == std::string::npos);
+
+    // Absolute RESULT_FILENAMEs are used as they are.
+    track::Config point;
+    point.script_dir = script_dir;
+    point.result_filename = batch_dir + "/result_isl100_osl30_conc4";
+    CHECK(track::result_path(point, ".json") == batch_dir + "/result_isl100_osl30_conc4.json");
+    point.result_filename = "result";
+    CHECK(track::result_path(point, ".json") == script_dir + "/result.json");
+
+    track::execute_command("rm -rf '" + base + "'", nullptr, false);
+    return failures == 0 ? 0 : 1;
+}
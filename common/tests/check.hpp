@@ -0,0 +1,19 @@
+// ============================================
+// Test Checks
+// ============================================
+// CHECK(cond) reports a failed condition with its location and keeps going;
+// a test's main() returns `failures == 0 ? 0 : 1` at the end.
+
+#pragma once
+
+#include <iostream>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond << std::endl; \
+            failures++;                                                          \
+        }                                                                        \
+    } while (0)
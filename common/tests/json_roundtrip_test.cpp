@@ -0,0 +1,52 @@
+// ============================================
+// JSON Round-Trip Test
+// ============================================
+// Everything JsonValue::dump writes must parse back with json_parse. Result
+// files carry ratios and means that can be NaN or infinite (an empty run, a
+// zero baseline); those are written as null, the rest round-trip unchanged.
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "../json.hpp"
+#include "check.hpp"
+
+int main() {
+    JsonValue doc = JsonValue::object();
+    doc.set("nan", std::numeric_limits<double>::quiet_NaN());
+    doc.set("inf", std::numeric_limits<double>::infinity());
+    doc.set("neg_inf", -std::numeric_limits<double>::infinity());
+    doc.set("ratio", 1.25);
+    doc.set("whole", 3.0);
+    doc.set("count", 42);
+    doc.set("name", std::string("team \"o'brien\"\n"));
+    JsonValue values = JsonValue::array();
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+    values.push_back(0.5);
+    doc.set("values", values);
+
+    for (int indent : {-1, 2}) {
+        std::string text = doc.dump(indent);
+        JsonValue back;
+        std::string error;
+        CHECK(json_parse(text, back, &error));
+        if (!error.empty()) std::cerr << "  " << error << "\n  in: " << text << std::endl;
+
+        CHECK(back["nan"].is_null());
+        CHECK(back["inf"].is_null());
+        CHECK(back["neg_inf"].is_null());
+        CHECK(back["ratio"].as_double() == 1.25);
+        CHECK(back["whole"].type() == JsonValue::DOUBLE && back["whole"].as_double() == 3.0);
+        CHECK(back["count"].as_int() == 42);
+        CHECK(back["name"].as_string() == "team \"o'brien\"\n");
+        CHECK(back["values"].items().size() == 2);
+        CHECK(back["values"][0].is_null());
+        CHECK(back["values"][1].as_double() == 0.5);
+
+        // A second pass writes the same text: nothing drifts.
+        CHECK(back.dump(indent) == text);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
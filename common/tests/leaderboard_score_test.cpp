@@ -0,0 +1,65 @@
+// ============================================
+// Leaderboard Scoring Test
+// ============================================
+// Curve dominance comes before the per-CONC layers: an entry whose curve
+// covers another's places above it at every CONC, even where the other's
+// point at that CONC wins on the tie-breaker.
+
+#include <iostream>
+
+#include "../leaderboard_score.hpp"
+#include "check.hpp"
+
+static const ScoreStanding& find(const std::vector<ScoreStanding>& standings, const std::string& name) {
+    for (const ScoreStanding& s : standings) {
+        if (s.name == name) return s;
+    }
+    static ScoreStanding none;
+    failures++;
+    return none;
+}
+
+int main() {
+    const std::vector<int> concs = {4, 8, 32};
+
+    // B's CONC=4 point trades throughput for latency and wins the 50/30/20
+    // tie-breaker against A's, but A's CONC=8 point beats it outright, and
+    // every other B point is beaten too: A's curve dominates.
+    ScoreEntry a{"a", {{4, {100, 50, 1000}}, {8, {120, 65, 850}}, {32, {400, 20, 3000}}}};
+    ScoreEntry b{"b", {{4, {90, 60, 900}}, {8, {110, 40, 1200}}, {32, {300, 15, 3500}}}};
+    CHECK(score_curve_dominates(a, b, concs));
+    CHECK(!score_curve_dominates(b, a, concs));
+
+    std::vector<ScoreStanding> standings = score_entries({b, a}, concs);
+    CHECK(standings.size() == 2 && standings[0].name == "a");
+    CHECK(find(standings, "a").curve_layer == 0);
+    CHECK(find(standings, "b").curve_layer == 1);
+    CHECK(find(standings, "a").placings.at(4).place == 1);
+    CHECK(find(standings, "b").placings.at(4).place == 2);
+    CHECK(find(standings, "b").placings.at(4).weighted > find(standings, "a").placings.at(4).weighted);
+    CHECK(find(standings, "a").total == 3000);
+
+    // Intersecting curves: neither dominates, the per-CONC rules decide.
+    ScoreEntry c{"c", {{4, {200, 10, 5000}}, {8, {210, 9, 5200}}, {32, {500, 8, 5400}}}};
+    CHECK(!score_curve_dominates(a, c, concs) && !score_curve_dominates(c, a, concs));
+    standings = score_entries({a, c}, concs);
+    CHECK(find(standings, "a").curve_layer == 0 && find(standings, "c").curve_layer == 0);
+
+    // Same frontier, different weaker points: the curves cover each other,
+    // so neither dominates and the layering still terminates.
+    ScoreEntry d{"d", {{4, {100, 50, 1000}}, {8, {120, 65, 850}}, {32, {400, 20, 3000}}}};
+    ScoreEntry e{"e", {{4, {99, 49, 1001}}, {8, {120, 65, 850}}, {32, {400, 20, 3000}}}};
+    CHECK(!score_curve_dominates(d, e, concs) && !score_curve_dominates(e, d, concs));
+    standings = score_entries({d, e}, concs);
+    CHECK(find(standings, "d").curve_layer == 0 && find(standings, "e").curve_layer == 0);
+
+    // A curve can dominate from fewer CONCs; the entry still scores nothing
+    // where it has no point.
+    ScoreEntry partial{"partial", {{4, {1000, 1000, 1}}}};
+    standings = score_entries({a, partial}, concs);
+    CHECK(find(standings, "partial").placings.count(8) == 0);
+    CHECK(find(standings, "partial").placings.at(4).place == 1);
+    CHECK(find(standings, "a").curve_layer == 1);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+#!/bin/bash
+# ============================================
+# Engine Unit Tests
+# ============================================
+# Builds and runs every common/tests/*_test.cpp with the same flags as the
+# track binaries. No server is needed.
+#
+# Usage:
+#   bash common/tests/run_tests.sh
+
+set -u
+cd "$(dirname "$0")"
+out=$(mktemp -d)
+rc=0
+for src in *_test.cpp; do
+    name=${src%.cpp}
+    if ! g++ -std=c++17 -Wall -o "$out/$name" "$src" -lcurl -pthread -O2; then
+        echo "FAILED to build $name"
+        rc=1
+        continue
+    fi
+    if "$out/$name"; then
+        echo "PASSED $name"
+    else
+        echo "FAILED $name"
+        rc=1
+    fi
+done
+rm -rf "$out"
+exit $rc
@@ -0,0 +1,126 @@
+// ============================================
+// Per-Request Timeline Export (Chrome Trace / Perfetto)
+// ============================================
+// Writes every request of a run as Chrome trace-event JSON, which both
+// chrome://tracing and ui.perfetto.dev open directly. Timestamps are in
+// microseconds from the start of the measured run.
+//
+// Layout:
+//   - one track per client connection slot, holding a slice per request with
+//     "prefill" (send -> first token) and "decode" (first token -> done)
+//     children, plus instants for the first response byte and every token chunk;
+//   - a "scheduler" track with async "queued" slices from each request's
+//     intended send time (enqueue) to its actual send, when it was late;
+//   - an "in-flight" counter, stepping at every send and completion.
+//
+// With this, prefill interference shows up as decode slices stretching
+// whenever another slot is in prefill, periodic stalls as aligned gaps in the
+// token instants across all slots, and head-of-line blocking as queued slices
+// piling up behind one long request.
+
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "workload.hpp"
+
+static const int TRACE_PID = 1;
+static const int TRACE_SCHEDULER_TID = 0;       // slot s lives on tid s + 1
+static const double TRACE_MIN_QUEUE_MS = 1.0;   // send lag below this is scheduling jitter
+
+inline bool write_request_trace(const std::string& path, const std::vector<RequestResult>& requests,
+                                const std::string& title, bool token_events = true) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << std::fixed << std::setprecision(3);
+
+    bool first = true;
+    auto begin_event = [&]() -> std::ofstream& {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        return out;
+    };
+    auto us = [](double seconds) { return seconds * 1e6; };
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    // Track names.
+    int max_slot = -1;
+    for (const auto& r : requests) max_slot = std::max(max_slot, r.slot);
+    begin_event() << "{\"ph\": \"M\", \"pid\": " << TRACE_PID << ", \"name\": \"process_name\", \"args\": {\"name\": \""
+                  << loadgen_json_escape(title) << "\"}}";
+    begin_event() << "{\"ph\": \"M\", \"pid\": " << TRACE_PID << ", \"tid\": " << TRACE_SCHEDULER_TID
+                  << ", \"name\": \"thread_name\", \"args\": {\"name\": \"scheduler\"}}";
+    for (int s = 0; s <= max_slot; s++) {
+        begin_event() << "{\"ph\": \"M\", \"pid\": " << TRACE_PID << ", \"tid\": " << s + 1
+                      << ", \"name\": \"thread_name\", \"args\": {\"name\": \"slot " << s << "\"}}";
+        begin_event() << "{\"ph\": \"M\", \"pid\": " << TRACE_PID << ", \"tid\": " << s + 1
+                      << ", \"name\": \"thread_sort_index\", \"args\": {\"sort_index\": " << s + 1 << "}}";
+    }
+
+    std::vector<std::pair<double, int>> edges;
+    for (size_t i = 0; i < requests.size(); i++) {
+        const RequestResult& r = requests[i];
+        if (r.slot < 0) continue;                   // never sent
+        int tid = r.slot + 1;
+        double send = r.send_time_s;
+        double done = send + (r.success ? r.e2el_ms : r.first_byte_ms) / 1000.0;
+        edges.push_back({send, +1});
+        edges.push_back({done, -1});
+
+        // Enqueue -> send, only when the request went out late.
+        if (r.send_lag_ms >= TRACE_MIN_QUEUE_MS) {
+            begin_event() << "{\"ph\": \"b\", \"cat\": \"queue\", \"name\": \"queued\", \"id\": " << i
+                          << ", \"pid\": " << TRACE_PID << ", \"tid\": " << TRACE_SCHEDULER_TID
+                          << ", \"ts\": " << us(r.intended_start_s) << "}";
+            begin_event() << "{\"ph\": \"e\", \"cat\": \"queue\", \"name\": \"queued\", \"id\": " << i
+                          << ", \"pid\": " << TRACE_PID << ", \"tid\": " << TRACE_SCHEDULER_TID
+                          << ", \"ts\": " << us(send) << "}";
+        }
+
+        begin_event() << "{\"ph\": \"X\", \"cat\": \"request\", \"name\": \"request " << i << "\", \"pid\": "
+                      << TRACE_PID << ", \"tid\": " << tid << ", \"ts\": " << us(send)
+                      << ", \"dur\": " << us(done - send) << ", \"args\": {\"prompt_len\": " << r.prompt_len
+                      << ", \"output_len\": " << r.output_len << ", \"ttft_ms\": " << r.ttft_ms
+                      << ", \"e2el_ms\": " << r.e2el_ms << ", \"send_lag_ms\": " << r.send_lag_ms
+                      << ", \"error\": \"" << loadgen_json_escape(r.error) << "\"}}";
+        if (r.first_byte_ms > 0) {
+            begin_event() << "{\"ph\": \"i\", \"s\": \"t\", \"cat\": \"request\", \"name\": \"first byte\", \"pid\": "
+                          << TRACE_PID << ", \"tid\": " << tid << ", \"ts\": " << us(send + r.first_byte_ms / 1000.0)
+                          << "}";
+        }
+        if (!r.success) continue;
+
+        double first_token = send + r.ttft_ms / 1000.0;
+        begin_event() << "{\"ph\": \"X\", \"cat\": \"phase\", \"name\": \"prefill\", \"pid\": " << TRACE_PID
+                      << ", \"tid\": " << tid << ", \"ts\": " << us(send) << ", \"dur\": " << us(first_token - send)
+                      << "}";
+        begin_event() << "{\"ph\": \"X\", \"cat\": \"phase\", \"name\": \"decode\", \"pid\": " << TRACE_PID
+                      << ", \"tid\": " << tid << ", \"ts\": " << us(first_token)
+                      << ", \"dur\": " << us(done - first_token) << "}";
+        if (!token_events) continue;
+        double t = first_token;
+        for (size_t j = 0; j <= r.itl_ms.size(); j++) {
+            if (j > 0) t += r.itl_ms[j - 1] / 1000.0;
+            begin_event() << "{\"ph\": \"i\", \"s\": \"t\", \"cat\": \"token\", \"name\": \"chunk\", \"pid\": "
+                          << TRACE_PID << ", \"tid\": " << tid << ", \"ts\": " << us(t) << "}";
+        }
+    }
+
+    // Completions sort before sends at the same instant.
+    std::sort(edges.begin(), edges.end());
+    int inflight = 0;
+    for (const auto& e : edges) {
+        inflight += e.second;
+        begin_event() << "{\"ph\": \"C\", \"name\": \"in-flight\", \"pid\": " << TRACE_PID << ", \"ts\": "
+                      << us(e.first) << ", \"args\": {\"requests\": " << inflight << "}}";
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
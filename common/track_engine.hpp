@@ -0,0 +1,2293 @@
+// ============================================
+// Track Benchmark Engine
+// ============================================
+// The accuracy gate, performance run, result post-processing, leaderboard
+// submission and multi-CONC driver shared by every track binary. Each track
+// directory compiles one translation unit that defines its profile
+// (track_profile.hpp) and calls track::track_main<Profile>().
+//
+// Usage of a track binary:
+//   ./<binary> acc                                    # Run accuracy test only
+//   ./<binary> perf                                   # Run accuracy + performance tests
+//   ./<binary> submit <team>                          # Run all tests + submit to leaderboard
+//   ./<binary> submit <team> -isl 8192 -osl 1024      # Batch test the CONC set + submit
+//   ./<binary> perf -isl 1024,8192 -osl 1024 -conc 1,4,16  # Sweep an ISL x OSL x CONC matrix
+//   ./<binary> perf --preset curve [--plan]           # CONC 1-256 over 1k..8k/1k (--plan: estimate only)
+//   ./<binary> perf --resume <batch_dir>              # Rerun a batch's missing or failed points
+//   ./<binary> score <batch_dir> [name=<dir|json>]... # Rank batches by the leaderboard rules
+//   ./<binary> recover <result>.journal.jsonl         # Rebuild a crashed run's summary
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <regex>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <ctime>
+#include <libgen.h>
+#include <limits.h>
+#include <limits>
+
+#include <cmath>
+
+#include "batch_manifest.hpp"
+#include "json.hpp"
+#include "loadgen.hpp"
+#include "gpu_layout.hpp"
+#include "leaderboard_score.hpp"
+#include "server_process.hpp"
+#include "svg_chart.hpp"
+#include "sweep_plan.hpp"
+#include "track_profile.hpp"
+
+namespace track {
+
+using namespace std;
+
+// ============================================
+// Configuration Structure
+// ============================================
+struct Config {
+    string mode;
+    string team_name;
+    string isl_arg;             // -isl / -osl / -conc: comma-separated sweep lists
+    string osl_arg;
+    string conc_arg;
+    string preset;              // --preset: leaderboard, curve
+    bool plan_only = false;     // --plan: print the sweep plan and exit
+    string resume_dir;          // --resume: batch directory to complete
+    
+    // Environment variables
+    string model;
+    int port = 8888;
+    int tp = 8;
+    vector<int> server_ports;   // SERVER_PORTS: one per data-parallel instance; empty = PORT only
+    int num_instances = 1;      // NUM_INSTANCES, for replicas behind one router port
+    int num_gpus = 0;           // NUM_GPUS override; 0 = TP x instances
+    GpuLayout gpu;
+    int conc = 4;
+    int isl = 8192;
+    int osl = 1024;
+    int max_model_len = 0;      // exported to the server when the track sets one
+    double random_range_ratio = 1.0;
+    string result_filename = "result";
+    
+    // Arrival process (see common/arrival.hpp); "inf" = closed loop
+    string arrival_mode = "inf";
+    double request_rate = numeric_limits<double>::infinity();
+    double burstiness = 1.0;
+    string arrival_trace;
+    
+    // Headline TTFT/E2E definition: "service" or "response_time" (from intended send, open loop only)
+    string latency_definition = "service";
+    int hist_significant_digits = 3;  // HDR histogram precision for percentiles
+    int client_threads = 0;           // load generator worker threads; 0 = auto
+    bool pin_client_threads = true;
+    int num_warmups = -1;             // -1 = one per concurrency slot
+    double steady_tolerance = 0.15;   // steady window: max throughput deviation per bin
+    string prompt_format = "text";    // "text" or "token_ids" (bypasses server tokenization)
+    int trace_export = 0;             // 0 = off, 1 = request timelines, 2 = plus every token chunk
+    bool result_journal = true;       // <result>.journal.jsonl, one fsync'd record per completed request
+    int journal_sync_every = 64;      // records per fsync
+    bool accuracy_cache = true;       // reuse GSM8K results measured on the same server (fingerprint)
+    string accuracy_cache_file;       // empty = accuracy_cache.json next to the binary
+    int num_prompts = 0;
+    // ADAPTIVE_SAMPLES=1: run until the median TPOT, median E2E and throughput
+    // 95% bootstrap CIs are within adaptive_ci; num_prompts is then the cap.
+    bool adaptive_samples = false;
+    double adaptive_ci = 0.02;
+    int adaptive_min_prompts = 0;     // 0 = max(2 x CONC, 40)
+    int adaptive_max_prompts = 0;     // 0 = max(CONC x prompts_per_conc, 400)
+    
+    string lb_url_override;
+    bool multi_conc_mode = false;
+    vector<string> mode_inputs;                 // score: batch dirs / result files (name=path); recover: journals
+    string script_dir;
+};
+
+// ============================================
+// Utility Functions
+// ============================================
+
+inline string get_executable_path() {
+    char result[PATH_MAX];
+    ssize_t count = readlink("/proc/self/exe", result, PATH_MAX);
+    if (count != -1) {
+        result[count] = '\0';
+        return string(result);
+    }
+    return "";
+}
+
+inline string get_executable_dir() {
+    string exe_path = get_executable_path();
+    if (exe_path.empty()) {
+        return "";
+    }
+    // Get directory path
+    char* path_copy = strdup(exe_path.c_str());
+    char* dir = dirname(path_copy);
+    string result(dir);
+    free(path_copy);
+    return result;
+}
+
+inline string get_env_var(const string& name, const string& default_value = "") {
+    const char* val = getenv(name.c_str());
+    return val ? string(val) : default_value;
+}
+
+inline double get_env_double(const string& name, double default_value) {
+    const char* val = getenv(name.c_str());
+    return val && *val ? stod(val) : default_value;
+}
+
+inline string get_timestamp() {
+    auto now = chrono::system_clock::now();
+    auto time_t = chrono::system_clock::to_time_t(now);
+    stringstream ss;
+    ss << put_time(localtime(&time_t), "%Y%m%d_%H%M%S");
+    return ss.str();
+}
+
+inline string get_current_time_str() {
+    auto now = chrono::system_clock::now();
+    auto time_t = chrono::system_clock::to_time_t(now);
+    stringstream ss;
+    ss << put_time(localtime(&time_t), "%c");
+    return ss.str();
+}
+
+inline int execute_command(const string& cmd, string* output = nullptr, bool show_output = true) {
+    if (show_output) {
+        cout << "Executing: " << cmd << endl;
+    }
+    
+    if (output) {
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) return -1;
+        
+        char buffer[256];
+        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+            *output += buffer;
+            if (show_output) {
+                cout << buffer;
+            }
+        }
+        
+        int status = pclose(pipe);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    } else {
+        return system(cmd.c_str());
+    }
+}
+
+inline bool file_exists(const string& path) {
+    struct stat buffer;
+    return (stat(path.c_str(), &buffer) == 0);
+}
+
+inline string join_ints(const int* values, size_t n) {
+    string out;
+    for (size_t i = 0; i < n; i++) {
+        out += (i ? ", " : "") + to_string(values[i]);
+    }
+    return out;
+}
+
+inline vector<int> parse_int_list(const string& text) {
+    vector<int> values;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (item.find_first_not_of(" \t") != string::npos) {
+            values.push_back(stoi(item));
+        }
+    }
+    return values;
+}
+
+inline vector<int> instance_ports(const Config& cfg) {
+    return cfg.server_ports.empty() ? vector<int>{cfg.port} : cfg.server_ports;
+}
+
+// Adaptive sampling bounds for one CONC (see adaptive_sampling.hpp): the
+// cap defaults to at least 400 so low-CONC runs can go past CONC x 10, the
+// floor to two full waves.
+template <typename P>
+int adaptive_prompt_cap(const Config& cfg, int conc) {
+    if (cfg.adaptive_max_prompts > 0) {
+        return cfg.adaptive_max_prompts;
+    }
+    return max(conc * P::prompts_per_conc, 400);
+}
+
+inline int adaptive_prompt_floor(const Config& cfg) {
+    if (cfg.adaptive_min_prompts > 0) {
+        return cfg.adaptive_min_prompts;
+    }
+    return max(2 * cfg.conc, 40);
+}
+
+// A run's output file: RESULT_FILENAME plus `suffix`, under the binary's
+// directory unless RESULT_FILENAME is absolute (sweep points name theirs
+// inside the batch directory).
+inline string result_path(const Config& cfg, const string& suffix) {
+    if (!cfg.result_filename.empty() && cfg.result_filename[0] == '/') {
+        return cfg.result_filename + suffix;
+    }
+    return cfg.script_dir + "/" + cfg.result_filename + suffix;
+}
+
+inline string absolute_path(const string& path) {
+    char resolved[PATH_MAX];
+    if (realpath(path.c_str(), resolved) != nullptr) {
+        return resolved;
+    }
+    return path;
+}
+
+inline bool create_directory(const string& path) {
+    return mkdir(path.c_str(), 0755) == 0;
+}
+
+inline string extract_regex_match(const string& text, const regex& pattern, int group = 1) {
+    smatch match;
+    if (regex_search(text, match, pattern) && match.size() > static_cast<size_t>(group)) {
+        return match[group].str();
+    }
+    return "";
+}
+
+// Empty for a shape the leaderboard does not rank.
+template <typename P>
+string get_leaderboard_url(int isl, int osl) {
+    if (isl == P::isl && osl == P::osl) {
+        return P::leaderboard_url;
+    }
+    return "";
+}
+
+// ============================================
+// Run Benchmark Serving Function
+// ============================================
+inline ArrivalConfig make_arrival_config(const Config& cfg) {
+    ArrivalConfig arrival;
+    arrival.mode = cfg.arrival_mode;
+    arrival.request_rate = cfg.request_rate;
+    arrival.burstiness = cfg.burstiness;
+    arrival.trace_path = cfg.arrival_trace;
+    return arrival;
+}
+
+template <typename P>
+int run_benchmark_serving(const Config& cfg, BenchmarkResult& res, LoadGenSession& session) {
+    cout << "INFO: Starting performance benchmark (native load generator)..." << endl;
+    
+    LoadGenConfig lg;
+    lg.model = cfg.model;
+    lg.base_url = "http://0.0.0.0:" + to_string(cfg.port);
+    if (cfg.server_ports.size() > 1) {
+        for (int port : cfg.server_ports) {
+            lg.instance_urls.push_back("http://0.0.0.0:" + to_string(port));
+        }
+    }
+    lg.use_chat_template = P::use_chat_template;
+    lg.sglang_native = P::sglang_native;
+    lg.prompt_format = cfg.prompt_format;
+    lg.isl = cfg.isl;
+    lg.osl = cfg.osl;
+    lg.random_range_ratio = cfg.random_range_ratio;
+    lg.num_prompts = cfg.num_prompts;
+    lg.seed = prompt_seed(cfg.isl, cfg.osl, cfg.conc);
+    lg.max_concurrency = cfg.conc;
+    lg.num_warmups = cfg.num_warmups >= 0 ? cfg.num_warmups : cfg.conc;
+    lg.arrival = make_arrival_config(cfg);
+    lg.latency_definition = cfg.latency_definition;
+    lg.hist_significant_digits = cfg.hist_significant_digits;
+    lg.client_threads = cfg.client_threads;
+    lg.pin_client_threads = cfg.pin_client_threads;
+    lg.steady_tolerance = cfg.steady_tolerance;
+    if (cfg.adaptive_samples) {
+        lg.adaptive.enabled = true;
+        lg.adaptive.target_rel_ci = cfg.adaptive_ci;
+        lg.adaptive.min_prompts = adaptive_prompt_floor(cfg);
+    }
+    if (cfg.result_journal) {
+        lg.journal_path = result_path(cfg, ".journal.jsonl");
+        lg.journal_sync_every = cfg.journal_sync_every;
+    }
+    
+    if (run_load_generator(lg, res, session) != 0) {
+        return 1;
+    }
+    
+    if (cfg.trace_export > 0) {
+        string trace_file = result_path(cfg, ".trace.json");
+        string title = cfg.model + " ISL=" + to_string(cfg.isl) + " OSL=" + to_string(cfg.osl) +
+                       " CONC=" + to_string(cfg.conc);
+        if (write_request_trace(trace_file, res.requests, title, cfg.trace_export >= 2)) {
+            cout << "INFO: Request timeline saved to " << trace_file << " (open in ui.perfetto.dev)" << endl;
+        } else {
+            cout << "WARNING: Failed to write request timeline " << trace_file << endl;
+        }
+    }
+    
+    string columns_file = result_path(cfg, ".requests.bin");
+    if (write_request_columns(columns_file, res.requests)) {
+        cout << "INFO: Per-request results saved to " << columns_file << endl;
+    } else {
+        cout << "WARNING: Failed to write per-request results " << columns_file << endl;
+    }
+    
+    return 0;
+}
+
+// ============================================
+// Server Health Check
+// ============================================
+template <typename P>
+bool check_server_health(int port, int max_retries = 5, int delay_seconds = 3) {
+    cout << "INFO: Checking server health at http://0.0.0.0:" << port << endl;
+    
+    for (int attempt = 1; attempt <= max_retries; attempt++) {
+        stringstream cmd;
+        cmd << "curl -s -o /dev/null -w '%{http_code}' "
+            << "http://0.0.0.0:" << port << "/health 2>/dev/null";
+        
+        string output;
+        int ret = execute_command(cmd.str(), &output, false);
+        
+        // Remove whitespace
+        output.erase(remove_if(output.begin(), output.end(), ::isspace), output.end());
+        
+        if (output == "200" || output.find("200") != string::npos) {
+            cout << "SUCCESS: Server is healthy and responding" << endl;
+            return true;
+        }
+        
+        cout << "WARNING: Server health check failed (attempt " << attempt << "/" << max_retries 
+             << "), response: " << output << endl;
+        
+        if (attempt < max_retries) {
+            cout << "INFO: Waiting " << delay_seconds << " seconds before retry..." << endl;
+            sleep(delay_seconds);
+        }
+    }
+    
+    cerr << "ERROR: Server health check failed after " << max_retries << " attempts" << endl;
+    cerr << "ERROR: Please ensure " << P::server_name << " server is running on port " << port << endl;
+    return false;
+}
+
+template <typename P>
+bool check_server_health(const Config& cfg) {
+    for (int port : instance_ports(cfg)) {
+        if (!check_server_health<P>(port)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================
+// Server Fingerprint
+// ============================================
+// Identifies the server an accuracy result was measured against: the model
+// and ports; each instance's /v1/models and /version answers with
+// per-request fields (creation timestamps, permission ids) dropped; and,
+// when the server process is visible, its command line (--kv-cache-dtype,
+// parallelism, ...), tuning environment (SGLANG_USE_AITER, ...) and start
+// time. Any restart changes it.
+inline string fnv1a64_hex(const string& data) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+    return buf;
+}
+
+inline string fetch_server_json(int port, const string& path) {
+    string output;
+    int ret = execute_command("curl -s -m 10 http://0.0.0.0:" + to_string(port) + path + " 2>/dev/null", &output, false);
+    JsonValue doc;
+    if (ret != 0 || !json_parse(output, doc)) {
+        return "";
+    }
+    JsonValue stripped = JsonValue::object();
+    for (const auto& member : doc.members()) {
+        if (member.first == "created") continue;
+        if (member.first != "data") {
+            stripped.set(member.first, member.second);
+            continue;
+        }
+        JsonValue models = JsonValue::array();
+        for (const JsonValue& model : member.second.items()) {
+            JsonValue card = JsonValue::object();
+            for (const auto& field : model.members()) {
+                if (field.first != "created" && field.first != "permission") card.set(field.first, field.second);
+            }
+            models.push_back(card);
+        }
+        stripped.set("data", models);
+    }
+    return stripped.dump();
+}
+
+// process_start_time_seconds from the server's Prometheus endpoint (vLLM and
+// SGLang export the default process collector), or 0. Changes on every
+// restart, so it stands in for the start time when /proc cannot see the
+// server process.
+inline long long server_metrics_start_time(int port) {
+    string output;
+    if (execute_command("curl -s -m 10 http://0.0.0.0:" + to_string(port) + "/metrics 2>/dev/null", &output, false) != 0) {
+        return 0;
+    }
+    istringstream lines(output);
+    string line;
+    while (getline(lines, line)) {
+        if (line.compare(0, 26, "process_start_time_seconds") != 0) continue;
+        size_t space = line.find_last_of(' ');
+        if (space == string::npos) continue;
+        return static_cast<long long>(atof(line.c_str() + space + 1));
+    }
+    return 0;
+}
+
+// Hash of what the servers report and, per port, of the process behind it.
+// `identified` is cleared when some server's launch cannot be told apart from
+// a restart of it (no process on this host and no start time on /metrics):
+// such a fingerprint only covers the model card and version.
+inline string server_fingerprint(const Config& cfg, bool* identified = nullptr) {
+    if (identified) *identified = true;
+    string data = cfg.model;
+    for (int port : instance_ports(cfg)) {
+        data += "\n" + to_string(port) + "\n" + fetch_server_json(port, "/v1/models") + "\n" +
+                fetch_server_json(port, "/version");
+        ServerProcessInfo proc = find_server_process(port);
+        if (proc.pid >= 0) {
+            data += "\n" + proc.cmdline + "\n" + to_string(proc.start_time);
+            for (const auto& knob : proc.env_knobs) {
+                data += "\n" + knob.first + "=" + knob.second;
+            }
+            continue;
+        }
+        long long started = server_metrics_start_time(port);
+        if (started > 0) {
+            data += "\nstarted " + to_string(started);
+        } else if (identified) {
+            *identified = false;
+        }
+    }
+    return fnv1a64_hex(data);
+}
+
+// The context length the server reports (vLLM lists max_model_len on its
+// /v1/models cards), or 0.
+inline int server_max_model_len(const Config& cfg) {
+    JsonValue doc;
+    if (!json_parse(fetch_server_json(cfg.port, "/v1/models"), doc)) {
+        return 0;
+    }
+    for (const JsonValue& model : doc["data"].items()) {
+        if (model["max_model_len"].as_int() > 0) {
+            return static_cast<int>(model["max_model_len"].as_int());
+        }
+    }
+    return 0;
+}
+
+// ============================================
+// Run Accuracy Test
+// ============================================
+struct AccuracyMetrics {
+    // GSM8K metric from lm-eval output.
+    double gsm8k_metric = 0.0;
+    // Backward compatibility: downstream logic still reads gpqa_metric.
+    double gpqa_metric = 0.0;
+};
+
+template <typename P>
+int run_accuracy_test_gsm8k(const Config& cfg, AccuracyMetrics& metrics) {
+    cout << "INFO: Starting accuracy test (GSM8K via lm-eval)" << endl;
+    
+    // Check server health first
+    if (!check_server_health<P>(cfg)) {
+        cerr << "ERROR: Server is not responding. Cannot proceed with accuracy test." << endl;
+        return 1;
+    }
+
+    // Ensure lm_eval exists; install if missing.
+    int check_lm_eval_ret = execute_command("command -v lm_eval >/dev/null 2>&1", nullptr, false);
+    if (check_lm_eval_ret != 0) {
+        cout << "INFO: lm-eval not found, installing lm-eval[api]..." << endl;
+        string install_output;
+        int install_ret = execute_command("pip install \"lm-eval[api]\" 2>&1", &install_output);
+        if (install_ret != 0) {
+            cerr << "\nERROR: Failed to install lm-eval with exit code " << install_ret << endl;
+            return install_ret;
+        }
+    } else {
+        cout << "INFO: lm-eval already installed; skipping installation." << endl;
+    }
+
+    cout << "INFO: Running GSM8K evaluation (OpenAI-compatible API)" << endl;
+    
+    stringstream cmd;
+    cmd << "lm_eval --model local-completions"
+        << " --model_args model=" << cfg.model
+        << ",base_url=http://0.0.0.0:" << cfg.port
+        << "/v1/completions,num_concurrent=65,max_retries=1,tokenized_requests=False"
+        << " --tasks gsm8k"
+        << " --num_fewshot 3"
+        << " 2>&1";
+    
+    string output;
+    int ret = execute_command(cmd.str(), &output);
+    
+    if (ret != 0) {
+        cerr << "\nERROR: GSM8K accuracy test failed with exit code " << ret << endl;
+        return ret;
+    }
+
+    // Parse metric from lm_eval table/text output.
+    double parsed_metric = 0.0;
+    bool found_metric = false;
+
+    istringstream iss(output);
+    string line;
+    regex value_column_pattern(R"(\|\s*(?:acc|exact_match)\s*\|\s*[^|]*\|\s*([0-9]+(?:\.[0-9]+)?)\s*\|)");
+    regex float_pattern(R"(([0-9]+(?:\.[0-9]+)?))");
+    while (getline(iss, line)) {
+        if (line.find("gsm8k") == string::npos) {
+            continue;
+        }
+        if (line.find("acc") == string::npos && line.find("exact_match") == string::npos) {
+            continue;
+        }
+
+        // lm_eval table row format:
+        // |gsm8k|...|exact_match|↑|0.4246|±|0.0136|
+        // We want the Value column (0.4246), not the Stderr column.
+        smatch value_match;
+        if (regex_search(line, value_match, value_column_pattern) && value_match.size() > 1) {
+            parsed_metric = stod(value_match[1].str());
+            found_metric = true;
+            break;
+        }
+
+        // Fallback for slightly different table formats: first decimal on this row.
+        sregex_iterator it(line.begin(), line.end(), float_pattern);
+        sregex_iterator end;
+        for (; it != end; ++it) {
+            string num = (*it)[1].str();
+            if (num.find('.') != string::npos) {
+                parsed_metric = stod(num);
+                found_metric = true;
+                break;
+            }
+        }
+        if (found_metric) {
+            break;
+        }
+    }
+
+    if (!found_metric) {
+        regex fallback_metric_pattern(R"(acc(?:,none)?[^0-9]*([0-9]+(?:\.[0-9]+)?))");
+        string metric_str = extract_regex_match(output, fallback_metric_pattern);
+        if (!metric_str.empty()) {
+            parsed_metric = stod(metric_str);
+            found_metric = true;
+        }
+    }
+
+    if (!found_metric) {
+        cerr << "ERROR: Failed to parse GSM8K metric from lm-eval output." << endl;
+        return 1;
+    }
+
+    metrics.gsm8k_metric = parsed_metric;
+    metrics.gpqa_metric = parsed_metric;
+    
+    cout << "INFO: Accuracy metrics:" << endl;
+    cout << "  GSM8K metric: " << metrics.gsm8k_metric << endl;
+    
+    return 0;
+}
+
+// ============================================
+// Accuracy Cache
+// ============================================
+// GSM8K results of earlier runs keyed by server fingerprint, so perf
+// iteration on an unchanged server starts benchmarking without an lm-eval
+// pass. ACC_CACHE=0 always measures; ACC_CACHE_FILE moves the cache
+// (default accuracy_cache.json next to the binary). The cache is neither read
+// nor written when the fingerprint cannot see restarts (server_fingerprint).
+inline string accuracy_cache_path(const Config& cfg) {
+    return cfg.accuracy_cache_file.empty() ? cfg.script_dir + "/accuracy_cache.json" : cfg.accuracy_cache_file;
+}
+
+inline bool load_cached_accuracy(const string& cache_file, const string& fingerprint, AccuracyMetrics& metrics,
+                                 string* measured_at) {
+    JsonValue cache;
+    if (!file_exists(cache_file) || !json_parse_file(cache_file, cache)) {
+        return false;
+    }
+    const JsonValue& entry = cache["entries"][fingerprint];
+    if (!entry.is_object() || !entry["gsm8k_metric"].is_number()) {
+        return false;
+    }
+    metrics = AccuracyMetrics();
+    metrics.gsm8k_metric = entry["gsm8k_metric"].as_double();
+    metrics.gpqa_metric = metrics.gsm8k_metric;
+    if (measured_at) {
+        *measured_at = entry["measured_at"].as_string();
+    }
+    return true;
+}
+
+inline void store_cached_accuracy(const string& cache_file, const string& fingerprint, const Config& cfg,
+                                  const AccuracyMetrics& metrics) {
+    JsonValue cache;
+    if (!file_exists(cache_file) || !json_parse_file(cache_file, cache) || !cache["entries"].is_object()) {
+        cache = JsonValue::object();
+        cache.set("entries", JsonValue::object());
+    }
+    JsonValue entries = cache["entries"];
+    JsonValue entry = JsonValue::object();
+    entry.set("model", cfg.model);
+    entry.set("gsm8k_metric", metrics.gsm8k_metric);
+    entry.set("measured_at", get_current_time_str());
+    JsonValue servers = JsonValue::array();
+    for (int port : instance_ports(cfg)) {
+        ServerProcessInfo proc = find_server_process(port);
+        JsonValue server = JsonValue::object();
+        server.set("port", port);
+        server.set("pid", proc.pid);
+        server.set("cmdline", proc.cmdline);
+        server.set("start_time", proc.start_time);
+        servers.push_back(server);
+    }
+    entry.set("servers", servers);
+    entries.set(fingerprint, entry);
+    cache.set("entries", entries);
+    
+    string tmp_file = cache_file + ".tmp";
+    ofstream out(tmp_file);
+    out << cache.dump(2) << endl;
+    out.close();
+    if (!out || rename(tmp_file.c_str(), cache_file.c_str()) != 0) {
+        cout << "WARNING: Failed to update accuracy cache " << cache_file << endl;
+        return;
+    }
+    cout << "INFO: GSM8K metric cached for server " << fingerprint << " in " << cache_file << endl;
+}
+
+template <typename P>
+int run_accuracy_test(const Config& cfg, AccuracyMetrics& metrics) {
+    string fingerprint;
+    string cache_file = accuracy_cache_path(cfg);
+    bool use_cache = cfg.accuracy_cache;
+    if (use_cache) {
+        bool identified = true;
+        fingerprint = server_fingerprint(cfg, &identified);
+        string measured_at;
+        if (!identified) {
+            cout << "WARNING: Cannot tell this server launch from a restart (process not visible from here, "
+                 << "no process_start_time_seconds on /metrics); not using the accuracy cache" << endl;
+            use_cache = false;
+        } else if (load_cached_accuracy(cache_file, fingerprint, metrics, &measured_at)) {
+            cout << "INFO: Reusing GSM8K metric " << metrics.gsm8k_metric << " measured " << measured_at
+                 << " on this server (" << fingerprint << "); ACC_CACHE=0 measures again" << endl;
+            return 0;
+        }
+    }
+    
+    int ret = run_accuracy_test_gsm8k<P>(cfg, metrics);
+    if (ret == 0 && use_cache) {
+        store_cached_accuracy(cache_file, fingerprint, cfg, metrics);
+    }
+    return ret;
+}
+
+// ============================================
+// Validate Accuracy Metrics (GSM8K Baseline)
+// ============================================
+struct AccuracyGate {
+    double baseline = 0.0;
+    double tolerance = 0.0;                     // absolute
+
+    double minimum_accepted() const { return baseline - tolerance; }
+};
+
+// Override via environment variables if you need a different threshold.
+template <typename P>
+AccuracyGate get_accuracy_gate() {
+    AccuracyGate gate;
+    gate.baseline = get_env_double("GSM8K_BASELINE_METRIC", P::gsm8k_baseline);
+    gate.tolerance = get_env_double("GSM8K_TOL", 0.0);
+    return gate;
+}
+
+template <typename P>
+int validate_accuracy(const AccuracyMetrics& metrics) {
+    const AccuracyGate gate = get_accuracy_gate<P>();
+    const double BASELINE_GSM8K_METRIC = gate.baseline;
+    const double GSM8K_TOL = gate.tolerance;
+    const double MIN_ACCEPTED = gate.minimum_accepted();
+    
+    cout << "\nINFO: Validating GSM8K metric against baseline..." << endl;
+    cout << "  Baseline gsm8k_metric=" << BASELINE_GSM8K_METRIC << endl;
+    cout << "  Tolerance (absolute): " << GSM8K_TOL << endl;
+    cout << "  Minimum accepted: " << MIN_ACCEPTED << endl;
+    
+    if (metrics.gsm8k_metric < MIN_ACCEPTED) {
+        cout << "\nERROR: Accuracy validation FAILED!" << endl;
+        cout << "ERROR: gsm8k_metric too low: " << metrics.gsm8k_metric
+             << " < " << MIN_ACCEPTED << endl;
+        cout << "\nERROR: Performance benchmark will NOT be run due to accuracy validation failure." << endl;
+        cout << "ERROR: Please investigate and improve model accuracy before proceeding." << endl;
+        return 1;
+    }
+    
+    cout << "\nSUCCESS: Accuracy validation PASSED!" << endl;
+    cout << "✓ gsm8k_metric: " << metrics.gsm8k_metric << " ≥ " << MIN_ACCEPTED << endl;
+    cout << endl;
+    return 0;
+}
+
+// ============================================
+// Run Result
+// ============================================
+// The leaderboard numbers of one configuration, handed from the benchmark
+// straight to submission.
+struct RunResult {
+    int isl = 0;
+    int osl = 0;
+    int conc = 0;
+    double median_e2e_ms = 0.0;
+    double tput_per_gpu = 0.0;
+    double interactivity = 0.0;
+    double baseline_e2e_ms = 0.0;
+    double baseline_tput_per_gpu = 0.0;
+    double baseline_interactivity = 0.0;
+    double e2e_ratio = 0.0;
+    double tput_ratio = 0.0;
+    double interactivity_ratio = 0.0;
+    double gsm8k_metric = 0.0;
+    string latency_definition = "service";
+};
+
+// Reads a result file written by process_result_json at the end of each run
+// of this process; batches, `score` and `--resume` read points back through
+// it. Missing baselines read as 0.
+inline bool load_run_result(const string& result_file, RunResult& run) {
+    JsonValue data;
+    string error;
+    if (!json_parse_file(result_file, data, &error)) {
+        cerr << "ERROR: Failed to read " << result_file << ": " << error << endl;
+        return false;
+    }
+    const JsonValue& args = data["benchmark_args"];
+    const JsonValue& baseline = data["baseline_nv1126"];
+    run = RunResult();
+    run.isl = static_cast<int>(args["random_input_len"].as_int());
+    run.osl = static_cast<int>(args["random_output_len"].as_int());
+    run.conc = static_cast<int>(args["max_concurrency"].as_int());
+    run.median_e2e_ms = data["median_e2el_ms"].as_double();
+    run.tput_per_gpu = data["tput_per_gpu"].as_double();
+    run.interactivity = data["interactivity"].as_double();
+    run.baseline_e2e_ms = baseline["baseline_median_e2e_1126"].as_double();
+    run.baseline_tput_per_gpu = baseline["baseline_tput_pergpu_1126"].as_double();
+    run.baseline_interactivity = baseline["baseline_median_intvty_1126"].as_double();
+    run.e2e_ratio = data["median_e2e_ratio_vs_baseline_1126"].as_double();
+    run.tput_ratio = data["tput_per_gpu_ratio_vs_baseline_1126"].as_double();
+    run.interactivity_ratio = data["interactivity_ratio_vs_baseline_1126"].as_double();
+    run.gsm8k_metric = data["accuracy"]["gsm8k_metric"].as_double();
+    run.latency_definition = data["latency_definition"].as_string("service");
+    return true;
+}
+
+// ============================================
+// Process Result JSON and Add Metrics
+// ============================================
+// Writes the result file once: the run summary plus tput_per_gpu,
+// interactivity, baseline ratios and accuracy, derived from the in-memory
+// result.
+template <typename P>
+int process_result_json(const Config& cfg, const BenchmarkResult& res, const AccuracyMetrics& acc_metrics,
+                        RunResult& run) {
+    string result_file = result_path(cfg, ".json");
+    cout << "INFO: Adding metrics and writing " << result_file << endl;
+    
+    JsonValue summary = benchmark_summary_json(res);
+    
+    JsonValue args = JsonValue::object();
+    args.set("model", cfg.model);
+    args.set("backend", P::backend);
+    args.set("base_url", "http://0.0.0.0:" + to_string(cfg.port));
+    args.set("dataset_name", "random");
+    args.set("random_input_len", cfg.isl);
+    args.set("random_output_len", cfg.osl);
+    args.set("random_range_ratio", cfg.random_range_ratio);
+    args.set("num_prompts", cfg.adaptive_samples ? static_cast<int>(res.requests.size()) : cfg.num_prompts);
+    args.set("max_concurrency", cfg.conc);
+    args.set("request_rate", request_rate_json(res.arrival));
+    args.set("arrival_mode", res.arrival.mode);
+    args.set("burstiness", res.arrival.burstiness);
+    args.set("prompt_format", res.prompt_format);
+    summary.set("benchmark_args", args);
+    
+    double tput_per_gpu = res.total_token_throughput / cfg.gpu.num_gpus;
+    double interactivity = res.median_tpot_ms > 0 ? 1000.0 / res.median_tpot_ms : 0.0;
+    summary.set("tput_per_gpu", tput_per_gpu);
+    summary.set("interactivity", interactivity);
+    JsonValue layout = JsonValue::object();
+    layout.set("tp", cfg.gpu.tp);
+    layout.set("instances", cfg.gpu.instances);
+    layout.set("num_gpus", cfg.gpu.num_gpus);
+    layout.set("source", cfg.gpu.source);
+    summary.set("gpu_layout", layout);
+    
+    run = RunResult();
+    run.isl = cfg.isl;
+    run.osl = cfg.osl;
+    run.conc = cfg.conc;
+    run.median_e2e_ms = res.median_e2el_ms;
+    run.tput_per_gpu = tput_per_gpu;
+    run.interactivity = interactivity;
+    run.gsm8k_metric = acc_metrics.gsm8k_metric;
+    run.latency_definition = res.latency_definition;
+    
+    if (const BaselineTarget* baseline = find_baseline(P::baselines, cfg.isl, cfg.osl, cfg.conc)) {
+        const BaselineTarget& b = *baseline;
+        JsonValue targets = JsonValue::object();
+        targets.set("baseline_median_e2e_1126", b.median_e2e);
+        targets.set("baseline_tput_pergpu_1126", b.tput_per_gpu);
+        targets.set("baseline_median_intvty_1126", b.median_intvty);
+        summary.set("baseline_nv1126", targets);
+        
+        double tput_ratio = b.tput_per_gpu > 0 ? tput_per_gpu / b.tput_per_gpu : 0.0;
+        double e2e_ratio = b.median_e2e > 0 ? res.median_e2el_ms / b.median_e2e : 0.0;
+        double intvty_ratio = b.median_intvty > 0 ? interactivity / b.median_intvty : 0.0;
+        summary.set("tput_per_gpu_ratio_vs_baseline_1126", tput_ratio);
+        summary.set("median_e2e_ratio_vs_baseline_1126", e2e_ratio);
+        summary.set("interactivity_ratio_vs_baseline_1126", intvty_ratio);
+        run.baseline_e2e_ms = b.median_e2e;
+        run.baseline_tput_per_gpu = b.tput_per_gpu;
+        run.baseline_interactivity = b.median_intvty;
+        run.e2e_ratio = e2e_ratio;
+        run.tput_ratio = tput_ratio;
+        run.interactivity_ratio = intvty_ratio;
+        
+        cout << fixed << setprecision(4);
+        cout << "INFO: Baseline found for ISL=" << cfg.isl << ", OSL=" << cfg.osl << ", CONC=" << cfg.conc << endl;
+        cout << "INFO: Throughput ratio (MI355X/baseline, higher is better!): " << tput_ratio << endl;
+        cout << "INFO: E2E latency ratio (MI355X/baseline, lower is better!): " << e2e_ratio << endl;
+        cout << "INFO: Interactivity: " << setprecision(2) << interactivity << " tokens/s/user" << endl;
+        cout << "INFO: Interactivity ratio (MI355X/baseline, higher is better!): " << setprecision(4) << intvty_ratio << endl;
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+    } else {
+        cout << "WARNING: No baseline found for ISL=" << cfg.isl << ", OSL=" << cfg.osl << ", CONC=" << cfg.conc << endl;
+        summary.set("baseline_nv1126", nullptr);
+        summary.set("tput_per_gpu_ratio_vs_baseline_1126", nullptr);
+        summary.set("median_e2e_ratio_vs_baseline_1126", nullptr);
+        summary.set("interactivity_ratio_vs_baseline_1126", nullptr);
+    }
+    
+    JsonValue accuracy = JsonValue::object();
+    accuracy.set("task", "gsm8k");
+    accuracy.set("gsm8k_metric", acc_metrics.gsm8k_metric);
+    summary.set("accuracy", accuracy);
+    
+    // The gate validate_accuracy applied before the run.
+    const AccuracyGate gate = get_accuracy_gate<P>();
+    JsonValue validation = JsonValue::object();
+    validation.set("status", "PASSED");
+    validation.set("baseline_gsm8k_metric", gate.baseline);
+    validation.set("gsm8k_tol", gate.tolerance);
+    validation.set("minimum_accepted", gate.minimum_accepted());
+    summary.set("accuracy_validation", validation);
+    
+    ofstream out(result_file);
+    out << summary.dump(2);
+    out.close();
+    if (!out) {
+        cerr << "ERROR: Failed to write result file " << result_file << endl;
+        return 1;
+    }
+    cout << "INFO: Result file written with all metrics" << endl;
+    return 0;
+}
+
+// ============================================
+// Submit to Leaderboard
+// ============================================
+// Returns non-zero if any run was not accepted. `event_ids`, when given, gets
+// one entry per run: the leaderboard's event ID, or empty if it failed.
+inline int submit_to_leaderboard(const Config& cfg, const vector<RunResult>& runs, const string& lb_url,
+                                 vector<string>* event_ids = nullptr) {
+    cout << "\n============================================" << endl;
+    cout << "Submitting results to leaderboard" << endl;
+    cout << "============================================" << endl;
+    cout << "Team: " << cfg.team_name << endl;
+    cout << "Leaderboard URL: " << lb_url << endl;
+    
+    size_t failed = 0;
+    if (event_ids) {
+        event_ids->assign(runs.size(), "");
+    }
+    for (size_t r = 0; r < runs.size(); r++) {
+        const RunResult& run = runs[r];
+        if (run.latency_definition != "service") {
+            cout << "WARNING: median E2E was measured as " << run.latency_definition
+                 << " latency; the leaderboard targets assume service latency" << endl;
+        }
+        
+        cout << "\nConfiguration: ISL=" << run.isl << ", OSL=" << run.osl << ", CONC=" << run.conc << endl;
+        cout << "\nMI355X Performance:" << endl;
+        cout << "  E2E (median): " << run.median_e2e_ms << "ms (" << run.latency_definition << " latency)" << endl;
+        cout << "  Throughput per GPU: " << run.tput_per_gpu << " tokens/s" << endl;
+        cout << "  Interactivity: " << run.interactivity << " tokens/s/user" << endl;
+        cout << "\nBaseline (NV-1126):" << endl;
+        cout << "  E2E (median): " << run.baseline_e2e_ms << "ms" << endl;
+        cout << "  Throughput per GPU: " << run.baseline_tput_per_gpu << " tokens/s" << endl;
+        cout << "  Interactivity: " << run.baseline_interactivity << " tokens/s/user" << endl;
+        cout << "\nPerformance Ratios (MI355X / baseline):" << endl;
+        cout << "  E2E Ratio: " << run.e2e_ratio << endl;
+        cout << "  Throughput Ratio: " << run.tput_ratio << endl;
+        cout << "  Interactivity Ratio: " << run.interactivity_ratio << endl;
+        cout << "\nAccuracy metrics:" << endl;
+        cout << "  GSM8K metric: " << run.gsm8k_metric << endl;
+        
+        cout << "\nSubmitting to leaderboard..." << endl;
+        
+        // Serialised straight from the doubles, so nothing is rounded on the way.
+        JsonValue data = JsonValue::array();
+        data.push_back(cfg.team_name);
+        data.push_back(run.conc);
+        data.push_back(run.median_e2e_ms);
+        data.push_back(run.tput_per_gpu);
+        data.push_back(run.baseline_e2e_ms);
+        data.push_back(run.baseline_tput_per_gpu);
+        data.push_back(run.e2e_ratio);
+        data.push_back(run.tput_ratio);
+        data.push_back(run.interactivity);
+        data.push_back(run.baseline_interactivity);
+        data.push_back(run.interactivity_ratio);
+        data.push_back(run.gsm8k_metric);
+        JsonValue payload = JsonValue::object();
+        payload.set("data", data);
+        
+        // The body goes through a file, not the command line: a team name may
+        // hold any character, quotes included.
+        char body_path[] = "/tmp/lb_submit.XXXXXX";
+        int fd = mkstemp(body_path);
+        if (fd < 0) {
+            cerr << "ERROR: Failed to create a temporary file for the submission" << endl;
+            failed++;
+            continue;
+        }
+        close(fd);
+        ofstream body(body_path);
+        body << payload.dump();
+        body.close();
+        if (!body) {
+            cerr << "ERROR: Failed to write the submission to " << body_path << endl;
+            unlink(body_path);
+            failed++;
+            continue;
+        }
+        
+        stringstream curl_cmd;
+        curl_cmd << "curl -sS -X POST '" << lb_url << "/gradio_api/call/submit_results' "
+                 << "-H \"Content-Type: application/json\" "
+                 << "--data-binary @" << body_path;
+        
+        string submit_response;
+        int curl_rc = execute_command(curl_cmd.str(), &submit_response, false);
+        unlink(body_path);
+        if (curl_rc != 0) {
+            cerr << "ERROR: Submission of CONC=" << run.conc << " failed (curl exit code " << curl_rc << ")" << endl;
+            failed++;
+            continue;
+        }
+        
+        // Gradio answers {"event_id": "..."}; anything else was not accepted.
+        JsonValue submit_json;
+        string event_id;
+        if (json_parse(submit_response, submit_json)) {
+            event_id = submit_json["event_id"].as_string();
+        }
+        if (event_id.empty()) {
+            cerr << "ERROR: Leaderboard did not accept CONC=" << run.conc << ": " << submit_response << endl;
+            failed++;
+            continue;
+        }
+        cout << "  Event ID: " << event_id << endl;
+        if (event_ids) {
+            (*event_ids)[r] = event_id;
+        }
+    }
+    
+    sleep(2);
+    
+    cout << "\n============================================" << endl;
+    if (failed > 0) {
+        cout << "ERROR: " << failed << " of " << runs.size() << " result(s) were not submitted" << endl;
+        cout << "============================================" << endl;
+        return 1;
+    }
+    cout << "SUCCESS: Results submitted to leaderboard! 🎉" << endl;
+    cout << "Check it out @ " << lb_url << endl;
+    cout << "============================================" << endl;
+    
+    return 0;
+}
+
+// ============================================
+// Run Single Configuration Test
+// ============================================
+template <typename P>
+int run_single_test(Config cfg, const AccuracyMetrics& acc_metrics, LoadGenSession* session = nullptr,
+                    RunResult* result = nullptr) {
+    cout << "============================================" << endl;
+    cout << "Mode: " << cfg.mode << endl;
+    if (cfg.mode == "submit") {
+        cout << "Team: " << cfg.team_name << endl;
+        
+        string lb_url;
+        if (!cfg.lb_url_override.empty()) {
+            lb_url = cfg.lb_url_override;
+        } else {
+            lb_url = get_leaderboard_url<P>(cfg.isl, cfg.osl);
+        }
+        cout << "Leaderboard: " << lb_url << endl;
+    }
+    cout << "============================================" << endl;
+    
+    if (cfg.mode == "acc") {
+        cout << "\n============================================" << endl;
+        cout << "Mode: acc - Accuracy test completed" << endl;
+        cout << "============================================" << endl;
+        cout << "Accuracy metrics:" << endl;
+        cout << "  GSM8K metric: " << acc_metrics.gsm8k_metric << endl;
+        cout << "\nSUCCESS: Accuracy test completed successfully!" << endl;
+        cout << "Skipping performance benchmark (acc mode)" << endl;
+        return 0;
+    }
+    
+    BenchmarkResult res;
+    LoadGenSession local_session;
+    if (run_benchmark_serving<P>(cfg, res, session ? *session : local_session) != 0) {
+        cerr << "ERROR: Performance benchmark failed" << endl;
+        return 1;
+    }
+    
+    RunResult run;
+    if (process_result_json<P>(cfg, res, acc_metrics, run) != 0) {
+        cerr << "ERROR: Failed to process result JSON" << endl;
+        return 1;
+    }
+    if (result) {
+        *result = run;
+    }
+    
+    if (cfg.mode == "submit") {
+        string lb_url;
+        if (!cfg.lb_url_override.empty()) {
+            lb_url = cfg.lb_url_override;
+        } else {
+            lb_url = get_leaderboard_url<P>(cfg.isl, cfg.osl);
+        }
+        
+        if (submit_to_leaderboard(cfg, {run}, lb_url) != 0) {
+            cerr << "ERROR: Failed to submit to leaderboard" << endl;
+            return 1;
+        }
+    }
+    
+    cout << "\nSUCCESS: All tests completed successfully!" << endl;
+    return 0;
+}
+
+// ============================================
+// Batch Charts
+// ============================================
+// The README's two required plots over the batch's CONC points, with the
+// Pareto frontier and the track's targets overlaid. Returns the frontier
+// listing for summary.txt.
+inline ChartSpec frontier_chart(const string& title, const string& x_label, const vector<ChartPoint>& points,
+                                bool x_higher, const vector<ChartPoint>& targets, vector<size_t>& frontier) {
+    frontier = pareto_frontier(points, x_higher, true);
+    ChartSpec spec;
+    spec.title = title;
+    spec.x_label = x_label;
+    spec.y_label = "Throughput per GPU (tokens/s/GPU)";
+    ChartSeries measured;
+    measured.name = "MI355X";
+    measured.color = "#1f77b4";
+    measured.points = points;
+    ChartSeries front;
+    front.name = "Pareto frontier";
+    front.color = "#ff7f0e";
+    front.connect = true;
+    for (size_t i : frontier) {
+        front.points.push_back({points[i].x, points[i].y, ""});
+    }
+    ChartSeries target;
+    target.name = "Target";
+    target.color = "#2ca02c";
+    target.hollow = true;
+    target.points = targets;
+    spec.series = {target, front, measured};
+    return spec;
+}
+
+// One (ISL, OSL) shape; `suffix` tells the files of several shapes apart.
+template <typename P>
+vector<string> write_shape_charts(const string& dir, const string& suffix, const vector<RunResult>& runs) {
+    vector<ChartPoint> e2e_points, intvty_points, e2e_targets, intvty_targets;
+    for (const RunResult& run : runs) {
+        string label = "CONC=" + to_string(run.conc);
+        e2e_points.push_back({run.median_e2e_ms / 1000.0, run.tput_per_gpu, label});
+        intvty_points.push_back({run.interactivity, run.tput_per_gpu, label});
+        if (const BaselineTarget* b = find_baseline(P::baselines, run.isl, run.osl, run.conc)) {
+            e2e_targets.push_back({b->median_e2e / 1000.0, b->tput_per_gpu, label});
+            intvty_targets.push_back({b->median_intvty, b->tput_per_gpu, label});
+        }
+    }
+    
+    struct Chart {
+        string file;
+        string x_name;
+        const vector<ChartPoint>* points;
+        ChartSpec spec;
+        vector<size_t> frontier;
+    };
+    string title = P::track_name;
+    if (!suffix.empty()) {
+        title += " ISL=" + to_string(runs[0].isl) + " OSL=" + to_string(runs[0].osl);
+    }
+    vector<Chart> charts(2);
+    charts[0].file = dir + "/tput_vs_e2e" + suffix + ".svg";
+    charts[0].x_name = "E2E latency (s)";
+    charts[0].points = &e2e_points;
+    charts[0].spec = frontier_chart(title + ": throughput per GPU vs E2E latency", "Median E2E latency (s)",
+                                    e2e_points, false, e2e_targets, charts[0].frontier);
+    charts[1].file = dir + "/tput_vs_interactivity" + suffix + ".svg";
+    charts[1].x_name = "interactivity (tokens/s/user)";
+    charts[1].points = &intvty_points;
+    charts[1].spec = frontier_chart(title + ": throughput per GPU vs interactivity",
+                                    "Interactivity (tokens/s/user)", intvty_points, true, intvty_targets,
+                                    charts[1].frontier);
+    
+    vector<string> lines;
+    for (const Chart& chart : charts) {
+        if (write_svg_chart(chart.file, chart.spec)) {
+            cout << "INFO: Chart saved to " << chart.file << endl;
+        } else {
+            cout << "WARNING: Failed to write chart " << chart.file << endl;
+        }
+        lines.push_back("Pareto frontier, throughput per GPU vs " + chart.x_name +
+                        (suffix.empty() ? "" : " (ISL=" + to_string(runs[0].isl) + ", OSL=" + to_string(runs[0].osl) + ")") +
+                        ":");
+        for (size_t i : chart.frontier) {
+            const ChartPoint& pt = (*chart.points)[i];
+            stringstream line;
+            line << "  " << pt.label << ": " << fixed << setprecision(2) << pt.x << ", " << pt.y << " tokens/s/GPU";
+            lines.push_back(line.str());
+        }
+    }
+    return lines;
+}
+
+// Charts per (ISL, OSL) shape of the batch, suffixed _isl<ISL>_osl<OSL> when
+// the batch has more than one.
+template <typename P>
+vector<string> write_batch_charts(const string& dir, const vector<RunResult>& runs) {
+    map<pair<int, int>, vector<RunResult>> shapes;
+    for (const RunResult& run : runs) {
+        shapes[{run.isl, run.osl}].push_back(run);
+    }
+    vector<string> lines;
+    for (const auto& shape : shapes) {
+        string suffix;
+        if (shapes.size() > 1) {
+            suffix = "_isl" + to_string(shape.first.first) + "_osl" + to_string(shape.first.second);
+        }
+        for (const string& line : write_shape_charts<P>(dir, suffix, shape.second)) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+// ============================================
+// Run Configuration from the Environment
+// ============================================
+// Server, layout and load generator settings shared by a single run and
+// every point of a sweep.
+template <typename P>
+int load_env_config(Config& cfg, bool sweep) {
+    cfg.model = get_env_var("MODEL");
+    if (cfg.model.empty()) {
+        cerr << "ERROR: MODEL environment variable is not set" << endl;
+        cerr << "Example: export MODEL='" << P::example_model << "'" << endl;
+        return 1;
+    }
+    
+    string port_str = get_env_var("PORT");
+    if (!port_str.empty()) {
+        cfg.port = stoi(port_str);
+    } else if (get_env_var("SERVER_PORTS").empty()) {
+        cout << "WARNING: PORT not set, using default 8888" << endl;
+    }
+    
+    string tp_str = get_env_var("TP");
+    if (!tp_str.empty()) {
+        cfg.tp = stoi(tp_str);
+    } else {
+        cout << "WARNING: TP not set, using default 8" << endl;
+    }
+    
+    string server_ports_str = get_env_var("SERVER_PORTS");
+    if (!server_ports_str.empty()) {
+        cfg.server_ports = parse_int_list(server_ports_str);
+        if (cfg.server_ports.empty()) {
+            cerr << "ERROR: SERVER_PORTS must be a comma-separated list of ports" << endl;
+            return 1;
+        }
+        cfg.port = cfg.server_ports[0];
+    }
+    cfg.num_instances = stoi(get_env_var("NUM_INSTANCES", to_string(max<size_t>(1, cfg.server_ports.size()))));
+    cfg.num_gpus = stoi(get_env_var("NUM_GPUS", "0"));
+    cfg.gpu = resolve_gpu_layout(cfg.tp, cfg.num_instances, cfg.num_gpus);
+    if (!cfg.gpu.warning.empty()) {
+        cout << "WARNING: " << cfg.gpu.warning << "; per-GPU throughput divides by " << cfg.gpu.num_gpus << endl;
+    }
+    if (cfg.gpu.num_gpus > 8) {
+        cout << "WARNING: " << cfg.gpu.num_gpus << " GPUs exceeds the single-node limit of 8" << endl;
+    }
+    
+    // A sweep sets CONC, ISL, OSL, NUM_PROMPTS and the result file per point.
+    if (!sweep) {
+        string conc_str = get_env_var("CONC");
+        if (!conc_str.empty()) {
+            cfg.conc = stoi(conc_str);
+        } else {
+            cout << "WARNING: CONC not set, using default " << cfg.conc << endl;
+        }
+        
+        string isl_str = get_env_var("ISL");
+        if (!isl_str.empty()) {
+            cfg.isl = stoi(isl_str);
+        } else {
+            cout << "WARNING: ISL not set, using default " << cfg.isl << endl;
+        }
+        
+        string osl_str = get_env_var("OSL");
+        if (!osl_str.empty()) {
+            cfg.osl = stoi(osl_str);
+        } else {
+            cout << "WARNING: OSL not set, using default " << cfg.osl << endl;
+        }
+    }
+    
+    string max_model_len_str = get_env_var("MAX_MODEL_LEN");
+    if (!max_model_len_str.empty()) {
+        cfg.max_model_len = stoi(max_model_len_str);
+    } else if (cfg.max_model_len > 0) {
+        cout << "WARNING: MAX_MODEL_LEN not set, using default " << cfg.max_model_len << endl;
+    }
+    
+    string ratio_str = get_env_var("RANDOM_RANGE_RATIO");
+    if (!ratio_str.empty()) {
+        cfg.random_range_ratio = stod(ratio_str);
+    } else {
+        cout << "WARNING: RANDOM_RANGE_RATIO not set, using default 1.0" << endl;
+    }
+    
+    string rate_str = get_env_var("REQUEST_RATE", "inf");
+    if (rate_str != "inf") {
+        cfg.request_rate = stod(rate_str);
+    }
+    cfg.arrival_trace = get_env_var("ARRIVAL_TRACE");
+    string default_arrival = "inf";
+    if (!cfg.arrival_trace.empty()) {
+        default_arrival = "trace";
+    } else if (!isinf(cfg.request_rate)) {
+        default_arrival = "poisson";
+    }
+    cfg.arrival_mode = get_env_var("ARRIVAL_MODE", default_arrival);
+    cfg.burstiness = stod(get_env_var("BURSTINESS", "1.0"));
+    cfg.hist_significant_digits = stoi(get_env_var("HIST_SIGNIFICANT_DIGITS", "3"));
+    cfg.client_threads = stoi(get_env_var("CLIENT_THREADS", "0"));
+    cfg.pin_client_threads = get_env_var("CLIENT_PIN", "1") != "0";
+    cfg.num_warmups = stoi(get_env_var("NUM_WARMUPS", "-1"));
+    cfg.steady_tolerance = stod(get_env_var("STEADY_TOLERANCE", "0.15"));
+    cfg.trace_export = stoi(get_env_var("TRACE_EXPORT", "0"));
+    cfg.result_journal = get_env_var("RESULT_JOURNAL", "1") != "0";
+    cfg.journal_sync_every = stoi(get_env_var("JOURNAL_SYNC_EVERY", "64"));
+    cfg.accuracy_cache = get_env_var("ACC_CACHE", "1") != "0";
+    cfg.accuracy_cache_file = get_env_var("ACC_CACHE_FILE");
+    cfg.adaptive_samples = get_env_var("ADAPTIVE_SAMPLES", "0") != "0";
+    cfg.adaptive_ci = stod(get_env_var("ADAPTIVE_CI", "0.02"));
+    cfg.adaptive_min_prompts = stoi(get_env_var("ADAPTIVE_MIN_PROMPTS", "0"));
+    cfg.adaptive_max_prompts = stoi(get_env_var("ADAPTIVE_MAX_PROMPTS", "0"));
+    if (cfg.adaptive_samples && cfg.adaptive_ci <= 0) {
+        cerr << "ERROR: ADAPTIVE_CI must be positive (e.g. 0.02 for +/-2%)" << endl;
+        return 1;
+    }
+    cfg.prompt_format = get_env_var("PROMPT_FORMAT", "text");
+    if (!is_valid_prompt_format(cfg.prompt_format)) {
+        cerr << "ERROR: PROMPT_FORMAT must be 'text' or 'token_ids'" << endl;
+        return 1;
+    }
+    cfg.latency_definition = get_env_var("LATENCY_DEFINITION", "service");
+    if (!is_valid_latency_definition(cfg.latency_definition)) {
+        cerr << "ERROR: LATENCY_DEFINITION must be 'service' or 'response_time'" << endl;
+        return 1;
+    }
+    if (!is_valid_arrival_mode(cfg.arrival_mode)) {
+        cerr << "ERROR: ARRIVAL_MODE must be one of inf, poisson, gamma, constant, trace" << endl;
+        return 1;
+    }
+    if (cfg.latency_definition == "response_time" && cfg.arrival_mode == "inf") {
+        cerr << "ERROR: LATENCY_DEFINITION=response_time needs an open-loop ARRIVAL_MODE "
+             << "(poisson, gamma, constant or trace); the closed loop has no intended send times" << endl;
+        return 1;
+    }
+    
+    if (!sweep) {
+        cfg.result_filename = get_env_var("RESULT_FILENAME", "result");
+        
+        string num_prompts_str = get_env_var("NUM_PROMPTS");
+        if (cfg.adaptive_samples) {
+            cfg.num_prompts = adaptive_prompt_cap<P>(cfg, cfg.conc);
+            if (!num_prompts_str.empty()) {
+                cout << "INFO: ADAPTIVE_SAMPLES=1: NUM_PROMPTS ignored, capping at " << cfg.num_prompts << endl;
+            }
+        } else if (!num_prompts_str.empty()) {
+            cfg.num_prompts = stoi(num_prompts_str);
+        } else {
+            cout << "WARNING: NUM_PROMPTS not set, using CONC * " << P::prompts_per_conc << endl;
+            cfg.num_prompts = cfg.conc * P::prompts_per_conc;
+        }
+    }
+    
+    cfg.lb_url_override = get_env_var("LB_URL_OVERRIDE");
+    
+    return 0;
+}
+
+inline void print_config(const Config& cfg) {
+    cout << "============================================" << endl;
+    cout << "Configuration:" << endl;
+    cout << "============================================" << endl;
+    cout << "MODEL:        " << cfg.model << endl;
+    cout << "PORT:         " << cfg.port << endl;
+    cout << "TP:           " << cfg.tp << endl;
+    if (cfg.server_ports.size() > 1) {
+        cout << "SERVER_PORTS: " << join_ints(cfg.server_ports.data(), cfg.server_ports.size()) << endl;
+    }
+    cout << "GPUS:         " << describe_gpu_layout(cfg.gpu) << endl;
+    cout << "CONC:         " << cfg.conc << endl;
+    cout << "ISL:          " << cfg.isl << endl;
+    cout << "OSL:          " << cfg.osl << endl;
+    if (cfg.max_model_len > 0) {
+        cout << "MAX_MODEL_LEN: " << cfg.max_model_len << endl;
+    }
+    if (cfg.adaptive_samples) {
+        cout << "NUM_PROMPTS:  " << adaptive_prompt_floor(cfg) << "-" << cfg.num_prompts << " (adaptive, CI +/-"
+             << cfg.adaptive_ci * 100 << "%)" << endl;
+    } else {
+        cout << "NUM_PROMPTS:  " << cfg.num_prompts << endl;
+    }
+    cout << "ARRIVALS:     " << describe_arrival(make_arrival_config(cfg)) << endl;
+    cout << "RESULT_FILE:  " << cfg.result_filename << ".json" << endl;
+    cout << "============================================" << endl;
+    cout << endl;
+}
+
+// ============================================
+// Result Files
+// ============================================
+// result*.json files of a batch directory (or the path itself when it is a
+// file), sorted; traces are skipped.
+inline bool is_result_json(const string& name) {
+    const string suffix = ".json";
+    return name.rfind("result", 0) == 0 && name.size() > suffix.size() &&
+           name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0 &&
+           name.find(".trace.json") == string::npos;
+}
+
+inline vector<string> list_result_files(const string& path) {
+    vector<string> files;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return files;
+    if (!S_ISDIR(st.st_mode)) {
+        files.push_back(path);
+        return files;
+    }
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return files;
+    while (struct dirent* ent = readdir(dir)) {
+        string name = ent->d_name;
+        if (is_result_json(name)) files.push_back(path + "/" + name);
+    }
+    closedir(dir);
+    sort(files.begin(), files.end());
+    return files;
+}
+
+// ============================================
+// Sweep Planning
+// ============================================
+// A sweep is an ISL x OSL x CONC matrix from the -isl/-osl/-conc lists or a
+// named preset; lists given on the command line replace the preset's:
+//   leaderboard  the track's shape and CONC set (the default; the only points
+//                submit mode submits)
+//   curve        CONC 1-256 over 1k/1k, 2k/1k, 4k/1k and 8k/1k, for sizing
+// Each point's runtime is estimated from the result files of earlier batch_*
+// directories next to the binary, where batches are written (sweep_plan.hpp).
+static const int CURVE_ISLS[] = {1024, 2048, 4096, 8192};
+static const int CURVE_OSLS[] = {1024};
+static const int CURVE_CONCS[] = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+
+struct SweepMatrix {
+    vector<int> isls;
+    vector<int> osls;
+    vector<int> concs;
+};
+
+template <typename P>
+int resolve_sweep_matrix(const Config& cfg, SweepMatrix& matrix) {
+    if (cfg.preset.empty() || cfg.preset == "leaderboard") {
+        matrix.isls = {P::isl};
+        matrix.osls = {P::osl};
+        matrix.concs.assign(begin(P::conc_values), end(P::conc_values));
+    } else if (cfg.preset == "curve") {
+        matrix.isls.assign(begin(CURVE_ISLS), end(CURVE_ISLS));
+        matrix.osls.assign(begin(CURVE_OSLS), end(CURVE_OSLS));
+        matrix.concs.assign(begin(CURVE_CONCS), end(CURVE_CONCS));
+    } else {
+        cerr << "ERROR: Unknown preset '" << cfg.preset << "' (leaderboard, curve)" << endl;
+        return 1;
+    }
+    try {
+        if (!cfg.isl_arg.empty()) matrix.isls = parse_int_list(cfg.isl_arg);
+        if (!cfg.osl_arg.empty()) matrix.osls = parse_int_list(cfg.osl_arg);
+        if (!cfg.conc_arg.empty()) matrix.concs = parse_int_list(cfg.conc_arg);
+    } catch (const exception&) {
+        cerr << "ERROR: -isl, -osl and -conc take comma-separated integers" << endl;
+        return 1;
+    }
+    for (const vector<int>* list : {&matrix.isls, &matrix.osls, &matrix.concs}) {
+        if (list->empty() || *min_element(list->begin(), list->end()) <= 0) {
+            cerr << "ERROR: -isl, -osl and -conc need positive values" << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+template <typename P>
+bool is_leaderboard_point(int isl, int osl, int conc) {
+    return isl == P::isl && osl == P::osl &&
+           find(begin(P::conc_values), end(P::conc_values), conc) != end(P::conc_values);
+}
+
+inline vector<PastRun> collect_past_runs(const string& dir) {
+    vector<PastRun> history;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return history;
+    vector<string> batches;
+    while (struct dirent* ent = readdir(d)) {
+        string name = ent->d_name;
+        if (name.rfind("batch_", 0) == 0) batches.push_back(dir + "/" + name);
+    }
+    closedir(d);
+    for (const string& batch : batches) {
+        for (const string& file : list_result_files(batch)) {
+            JsonValue data;
+            if (!json_parse_file(file, data)) continue;
+            const JsonValue& args = data["benchmark_args"];
+            PastRun run;
+            run.isl = static_cast<int>(args["random_input_len"].as_int());
+            run.osl = static_cast<int>(args["random_output_len"].as_int());
+            run.conc = static_cast<int>(args["max_concurrency"].as_int());
+            run.num_prompts = static_cast<int>(args["num_prompts"].as_int());
+            run.duration_s = data["benchmark_duration"].as_double();
+            run.median_e2el_ms = data["median_e2el_ms"].as_double();
+            history.push_back(run);
+        }
+    }
+    return history;
+}
+
+inline string sweep_point_label(const SweepPoint& p, bool single_shape) {
+    string label = "CONC=" + to_string(p.conc);
+    return single_shape ? label : "ISL=" + to_string(p.isl) + " OSL=" + to_string(p.osl) + " " + label;
+}
+
+inline void print_sweep_plan(ostream& out, const vector<SweepPoint>& plan, int max_model_len) {
+    out << "Plan (" << plan.size() << " points; * leaderboard, ! longer than the server's context):" << endl;
+    out << "        #    ISL    OSL   CONC  PROMPTS       EST  BASIS" << endl;
+    double total = 0;
+    int relaunch_len = 0;
+    for (size_t i = 0; i < plan.size(); i++) {
+        const SweepPoint& p = plan[i];
+        char row[192];
+        snprintf(row, sizeof(row), "    %c%c%3zu %6d %6d %6d %8d %9s  %s", p.leaderboard ? '*' : ' ',
+                 p.exceeds_context ? '!' : ' ', i + 1, p.isl, p.osl, p.conc, p.num_prompts,
+                 p.done ? "done" : format_duration(p.est_seconds).c_str(),
+                 p.done ? "kept from the resumed batch" : p.est_basis.c_str());
+        out << row << endl;
+        if (p.done) {
+            continue;
+        }
+        total += p.est_seconds;
+        if (p.exceeds_context) {
+            relaunch_len = max(relaunch_len, p.isl + p.osl);
+        }
+    }
+    out << "Estimated benchmark time: " << format_duration(total) << " (plus warmups and accuracy gates)" << endl;
+    if (relaunch_len > 0) {
+        out << "NOTE: The ! points need the server relaunched with max_model_len >= " << relaunch_len << " (now "
+            << max_model_len << "); they run last and are skipped while the server is too short" << endl;
+    }
+}
+
+// ============================================
+// Batch Checkpoints
+// ============================================
+// Every batch keeps a manifest (batch_manifest.hpp) next to its results.
+// `--resume <batch_dir>` rebuilds the batch's plan, keeps the points that
+// passed and whose result file still has the recorded hash, and reruns the
+// rest into the same directory; the accuracy gate before the first rerun
+// point is usually an accuracy cache hit.
+inline string result_file_hash(const string& path) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        return "";
+    }
+    stringstream ss;
+    ss << in.rdbuf();
+    return fnv1a64_hex(ss.str());
+}
+
+inline bool manifest_point_kept(const string& batch_dir, const ManifestPoint& mp) {
+    if (mp.status != "passed" || mp.result_hash.empty()) {
+        return false;
+    }
+    string hash = result_file_hash(batch_dir + "/" + mp.result_file);
+    if (hash != mp.result_hash) {
+        cout << "WARNING: " << batch_dir << "/" << mp.result_file
+             << (hash.empty() ? " is missing" : " changed since it was recorded") << "; rerunning it" << endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================
+// Run Sweep Mode (multi-CONC, ISL x OSL x CONC)
+// ============================================
+template <typename P>
+int run_multi_conc_mode(Config cfg) {
+    SweepMatrix matrix;
+    BatchManifest manifest;
+    const bool resuming = !cfg.resume_dir.empty();
+    // Absolute, so results, manifest and hashes agree whatever the cwd.
+    string batch_results_dir = resuming ? absolute_path(cfg.resume_dir) : "";
+    if (resuming) {
+        string err;
+        if (!read_batch_manifest(batch_results_dir + "/" + BATCH_MANIFEST_FILE, manifest, &err)) {
+            cerr << "ERROR: Cannot resume " << batch_results_dir << ": " << err << endl;
+            return 1;
+        }
+        if (!cfg.isl_arg.empty() || !cfg.osl_arg.empty() || !cfg.conc_arg.empty() || !cfg.preset.empty()) {
+            cout << "WARNING: --resume runs the batch's own matrix; -isl/-osl/-conc/--preset are ignored" << endl;
+        }
+        if (manifest.model != cfg.model) {
+            cout << "WARNING: " << batch_results_dir << " was measured with MODEL=" << manifest.model << ", now "
+                 << cfg.model << endl;
+        }
+        matrix.isls = manifest.isls;
+        matrix.osls = manifest.osls;
+        matrix.concs = manifest.concs;
+    } else if (resolve_sweep_matrix<P>(cfg, matrix) != 0) {
+        return 1;
+    }
+    int max_model_len = server_max_model_len(cfg);
+    if (max_model_len <= 0) {
+        max_model_len = cfg.max_model_len;
+    }
+    vector<PastRun> history = collect_past_runs(cfg.script_dir);
+    vector<SweepPoint> plan = plan_sweep(matrix.isls, matrix.osls, matrix.concs, P::prompts_per_conc, history,
+                                         max_model_len);
+    bool has_leaderboard_point = false;
+    for (SweepPoint& p : plan) {
+        if (cfg.adaptive_samples) {
+            // Sized and estimated at the cap; converged points finish sooner.
+            p.num_prompts = adaptive_prompt_cap<P>(cfg, p.conc);
+            estimate_sweep_point(p, history);
+        }
+        p.leaderboard = is_leaderboard_point<P>(p.isl, p.osl, p.conc);
+        has_leaderboard_point = has_leaderboard_point || p.leaderboard;
+        const ManifestPoint* mp = resuming ? manifest.find(p.isl, p.osl, p.conc) : nullptr;
+        p.done = mp && manifest_point_kept(batch_results_dir, *mp);
+    }
+    bool single_shape = matrix.isls.size() == 1 && matrix.osls.size() == 1;
+    
+    cout << "============================================" << endl;
+    cout << "Multi-Concurrency Testing Mode" << endl;
+    cout << "============================================" << endl;
+    cout << "ISL: " << join_ints(matrix.isls.data(), matrix.isls.size()) << endl;
+    cout << "OSL: " << join_ints(matrix.osls.data(), matrix.osls.size()) << endl;
+    cout << "CONC values: " << join_ints(matrix.concs.data(), matrix.concs.size()) << endl;
+    cout << "Mode: " << cfg.mode << endl;
+    if (resuming) {
+        cout << "Resuming: " << batch_results_dir << " (created " << manifest.created << ")" << endl;
+    }
+    string lb_url;
+    if (cfg.mode == "submit") {
+        cout << "Team: " << cfg.team_name << endl;
+        lb_url = cfg.lb_url_override.empty() ? get_leaderboard_url<P>(P::isl, P::osl) : cfg.lb_url_override;
+        cout << "Leaderboard: " << lb_url << endl;
+    }
+    cout << "============================================" << endl;
+    print_sweep_plan(cout, plan, max_model_len);
+    cout << endl;
+    
+    if (cfg.plan_only) {
+        return 0;
+    }
+    if (cfg.mode == "submit" && !has_leaderboard_point) {
+        cerr << "ERROR: Nothing to submit: the leaderboard ranks ISL=" << P::isl << ", OSL=" << P::osl
+             << " at CONC " << join_ints(P::conc_values, sizeof(P::conc_values) / sizeof(P::conc_values[0])) << endl;
+        return 1;
+    }
+    
+    if (resuming) {
+        manifest.resumed.push_back(get_current_time_str());
+    } else {
+        batch_results_dir = cfg.script_dir + "/" +
+                            (single_shape ? "batch_isl" + to_string(matrix.isls[0]) + "_osl" +
+                                                to_string(matrix.osls[0]) + "_" + get_timestamp()
+                                          : "batch_sweep_" + get_timestamp());
+        if (!create_directory(batch_results_dir)) {
+            cerr << "ERROR: Failed to create results directory" << endl;
+            return 1;
+        }
+        manifest.model = cfg.model;
+        manifest.mode = cfg.mode;
+        manifest.created = get_current_time_str();
+        manifest.isls = matrix.isls;
+        manifest.osls = matrix.osls;
+        manifest.concs = matrix.concs;
+    }
+    for (const SweepPoint& p : plan) {
+        if (!manifest.find(p.isl, p.osl, p.conc)) {
+            ManifestPoint mp;
+            mp.isl = p.isl;
+            mp.osl = p.osl;
+            mp.conc = p.conc;
+            mp.result_file = "result_isl" + to_string(p.isl) + "_osl" + to_string(p.osl) + "_conc" +
+                             to_string(p.conc) + ".json";
+            manifest.points.push_back(mp);
+        }
+    }
+    const string manifest_file = batch_results_dir + "/" + BATCH_MANIFEST_FILE;
+    if (!write_batch_manifest(manifest_file, manifest)) {
+        cout << "WARNING: Failed to write " << manifest_file << "; this batch cannot be resumed" << endl;
+    }
+    
+    cout << "Results directory: " << batch_results_dir << endl;
+    cout << endl;
+    
+    int passed = 0;
+    int failed = 0;
+    vector<RunResult> runs;
+    
+    string summary_file = batch_results_dir + "/summary.txt";
+    ofstream summary(summary_file);
+    summary << "Multi-Concurrency Test Results" << endl;
+    summary << "ISL: " << join_ints(matrix.isls.data(), matrix.isls.size())
+            << ", OSL: " << join_ints(matrix.osls.data(), matrix.osls.size()) << endl;
+    summary << "CONC values: " << join_ints(matrix.concs.data(), matrix.concs.size()) << endl;
+    summary << "Mode: " << cfg.mode << endl;
+    if (resuming) {
+        summary << "Time: " << manifest.created << endl;
+        summary << "Resumed: " << manifest.resumed.back() << endl;
+    } else {
+        summary << "Time: " << get_current_time_str() << endl;
+    }
+    print_sweep_plan(summary, plan, max_model_len);
+    summary << "============================================" << endl;
+    summary << endl;
+    summary.close();
+    
+    vector<Config> points;
+    int max_conc = 0;
+    for (const SweepPoint& p : plan) {
+        Config point = cfg;
+        // Submit mode benchmarks every point first and submits the leaderboard ones together below.
+        point.mode = cfg.mode == "submit" ? "perf" : cfg.mode;
+        point.isl = p.isl;
+        point.osl = p.osl;
+        point.conc = p.conc;
+        point.num_prompts = p.num_prompts;
+        point.result_filename = batch_results_dir + "/result_isl" + to_string(p.isl) + "_osl" + to_string(p.osl) +
+                                "_conc" + to_string(p.conc);
+        points.push_back(point);
+        if (!p.done) {
+            max_conc = max(max_conc, p.conc);
+        }
+    }
+    
+    // One accuracy gate for the whole sweep, shared by every point. Before
+    // each point the server fingerprint is compared with the one the gate
+    // ran against, and only a changed server is gated again.
+    AccuracyMetrics acc_metrics;
+    bool acc_ok = false;
+    string gate_fingerprint;
+    bool restarts_warned = false;
+    
+    // The client and its warm connections carry over from point to point;
+    // every point sends prompts of its own (prompt_seed).
+    LoadGenSession session;
+    session.reserve(max_conc);
+    
+    // Records how a point ended and checkpoints the manifest.
+    auto record_point = [&](const Config& point, const string& status, long long duration_s) {
+        ManifestPoint* mp = manifest.find(point.isl, point.osl, point.conc);
+        mp->status = status;
+        mp->result_hash = status == "passed" ? result_file_hash(result_path(point, ".json")) : "";
+        mp->duration_s = duration_s;
+        mp->finished_at = get_current_time_str();
+        mp->event_id.clear();                   // a new result has not been submitted yet
+        if (!write_batch_manifest(manifest_file, manifest)) {
+            cout << "WARNING: Failed to update " << manifest_file << endl;
+        }
+    };
+    
+    for (size_t k = 0; k < points.size(); k++) {
+        const Config& point = points[k];
+        const SweepPoint& planned = plan[k];
+        string label = sweep_point_label(planned, single_shape);
+        
+        if (planned.done) {
+            RunResult kept;
+            if (load_run_result(result_path(point, ".json"), kept)) {
+                passed++;
+                runs.push_back(kept);
+                const ManifestPoint* mp = manifest.find(point.isl, point.osl, point.conc);
+                string msg = "✓ " + label + ": PASSED (kept from " +
+                             (mp && !mp->finished_at.empty() ? mp->finished_at : string("the resumed batch")) + ")";
+                cout << msg << endl;
+                ofstream summary_kept(summary_file, ios::app);
+                summary_kept << msg << endl;
+                continue;
+            }
+            cout << "WARNING: Cannot read the kept result of " << label << "; rerunning it" << endl;
+        }
+        
+        cout << endl;
+        cout << "============================================" << endl;
+        cout << "Testing " << label << " (" << k + 1 << "/" << points.size() << ", est "
+             << format_duration(planned.est_seconds) << ")" << endl;
+        cout << "============================================" << endl;
+        print_config(point);
+        
+        if (planned.exceeds_context) {
+            int live_len = server_max_model_len(point);
+            if (live_len > 0 && point.isl + point.osl > live_len) {
+                failed++;
+                string msg = "✗ " + label + ": SKIPPED (needs max_model_len >= " + to_string(point.isl + point.osl) +
+                             ", server has " + to_string(live_len) + ")";
+                cout << msg << endl;
+                ofstream summary_skip(summary_file, ios::app);
+                summary_skip << msg << endl;
+                record_point(point, "skipped", 0);
+                continue;
+            }
+        }
+        
+        auto start_time = chrono::steady_clock::now();
+        
+        // A server that cannot be identified is gated once for the batch, as
+        // if it never changed; run_accuracy_test skips the on-disk cache.
+        bool identified = true;
+        string fingerprint = server_fingerprint(point, &identified);
+        if (!identified && !restarts_warned) {
+            cout << "WARNING: Server restarts cannot be detected from here; the accuracy gate runs once for "
+                 << "this batch; after restarting the server, stop and --resume the batch to gate it again" << endl;
+            restarts_warned = true;
+        }
+        if (gate_fingerprint.empty() || (identified && fingerprint != gate_fingerprint)) {
+            if (!gate_fingerprint.empty()) {
+                cout << "WARNING: Server fingerprint changed (" << gate_fingerprint << " -> " << fingerprint
+                     << "); re-running the accuracy gate" << endl;
+            }
+            acc_metrics = AccuracyMetrics();
+            acc_ok = run_accuracy_test<P>(point, acc_metrics) == 0 && validate_accuracy<P>(acc_metrics) == 0;
+            gate_fingerprint = fingerprint;
+            ofstream summary_gate(summary_file, ios::app);
+            summary_gate << "Accuracy gate before " << label << ": " << (acc_ok ? "PASSED" : "FAILED")
+                         << " (GSM8K " << acc_metrics.gsm8k_metric << ", server " << fingerprint << ")" << endl;
+        } else {
+            cout << "INFO: " << (identified ? "Server unchanged (" + fingerprint + ")" : string("Server not identifiable"))
+                 << ", reusing GSM8K metric " << acc_metrics.gsm8k_metric << endl;
+        }
+        
+        RunResult run;
+        int test_status = acc_ok ? run_single_test<P>(point, acc_metrics, &session, &run) : 1;
+        
+        auto end_time = chrono::steady_clock::now();
+        auto duration = chrono::duration_cast<chrono::seconds>(end_time - start_time).count();
+        
+        ofstream summary_append(summary_file, ios::app);
+        if (test_status == 0) {
+            passed++;
+            if (point.mode != "acc") {
+                runs.push_back(run);
+            }
+            string msg = "✓ " + label + ": PASSED (" + to_string(duration) + "s)";
+            cout << msg << endl;
+            summary_append << msg << endl;
+        } else {
+            failed++;
+            string msg = "✗ " + label + ": FAILED (" + to_string(duration) + "s)";
+            cout << msg << endl;
+            summary_append << msg << endl;
+        }
+        summary_append.close();
+        record_point(point, test_status == 0 ? "passed" : "failed", duration);
+        
+        if (acc_ok) {
+            sleep(2);
+        }
+    }
+    
+    ofstream summary_final(summary_file, ios::app);
+    summary_final << endl;
+    summary_final << "============================================" << endl;
+    summary_final << "Multi-Concurrency Test Complete!" << endl;
+    summary_final << "============================================" << endl;
+    summary_final << "Total tests: " << points.size() << endl;
+    summary_final << "Passed: " << passed << endl;
+    summary_final << "Failed: " << failed << endl;
+    summary_final << endl;
+    if (!runs.empty()) {
+        for (const string& chart_line : write_batch_charts<P>(batch_results_dir, runs)) {
+            summary_final << chart_line << endl;
+        }
+        summary_final << endl;
+    }
+    summary_final << "Results saved in: " << batch_results_dir << "/" << endl;
+    if (failed > 0) {
+        summary_final << "Rerun the failed points with: " << cfg.mode << (cfg.mode == "submit" ? " <team>" : "")
+                      << " --resume " << batch_results_dir << endl;
+    }
+    summary_final << "============================================" << endl;
+    summary_final.close();
+    
+    ifstream summary_read(summary_file);
+    string line;
+    bool print = false;
+    while (getline(summary_read, line)) {
+        if (line.empty() && !print) {
+            print = true;
+            continue;
+        }
+        if (print) {
+            cout << line << endl;
+        }
+    }
+    summary_read.close();
+    
+    if (cfg.mode == "submit") {
+        // Points an earlier run of this batch already submitted are not sent again.
+        vector<RunResult> lb_runs;
+        size_t already_submitted = 0;
+        for (const RunResult& run : runs) {
+            if (!is_leaderboard_point<P>(run.isl, run.osl, run.conc)) continue;
+            const ManifestPoint* mp = manifest.find(run.isl, run.osl, run.conc);
+            if (mp && !mp->event_id.empty()) {
+                cout << "INFO: CONC=" << run.conc << " was already submitted (event " << mp->event_id << ")" << endl;
+                already_submitted++;
+                continue;
+            }
+            lb_runs.push_back(run);
+        }
+        if (lb_runs.empty()) {
+            if (already_submitted > 0) {
+                cout << "INFO: Every passed leaderboard point of this batch is already submitted" << endl;
+                return 0;
+            }
+            cerr << "ERROR: No successful leaderboard results to submit" << endl;
+            return 1;
+        }
+        vector<string> event_ids;
+        int submit_status = submit_to_leaderboard(cfg, lb_runs, lb_url, &event_ids);
+        for (size_t r = 0; r < lb_runs.size(); r++) {
+            ManifestPoint* mp = manifest.find(lb_runs[r].isl, lb_runs[r].osl, lb_runs[r].conc);
+            if (mp && !event_ids[r].empty()) mp->event_id = event_ids[r];
+        }
+        if (!write_batch_manifest(manifest_file, manifest)) {
+            cout << "WARNING: Failed to record the submissions in " << manifest_file
+                 << "; resuming would submit them again" << endl;
+        }
+        return submit_status;
+    }
+    
+    return 0;
+}
+
+// ============================================
+// Score Mode (leaderboard simulation)
+// ============================================
+// Ranks result batches against each other with the README rules (see
+// leaderboard_score.hpp). An input is a batch directory written by
+// run_multi_conc_mode or a single result JSON, named after its path unless
+// given as name=path; historical or competitor snapshots only need the
+// result files. The track's baseline targets always take part as one entry.
+inline string score_entry_name(const string& input, string& path) {
+    size_t eq = input.find('=');
+    if (eq != string::npos && eq > 0 && input.find('/') > eq) {
+        path = input.substr(eq + 1);
+        return input.substr(0, eq);
+    }
+    path = input;
+    while (path.size() > 1 && path.back() == '/') path.pop_back();
+    size_t slash = path.rfind('/');
+    return slash == string::npos ? path : path.substr(slash + 1);
+}
+
+template <typename P>
+int run_score_mode(const Config& cfg) {
+    const size_t num_conc = sizeof(P::conc_values) / sizeof(P::conc_values[0]);
+    vector<int> conc_values(P::conc_values, P::conc_values + num_conc);
+    
+    cout << "============================================" << endl;
+    cout << "Leaderboard Simulation: " << P::track_name << endl;
+    cout << "============================================" << endl;
+    cout << "ISL: " << P::isl << ", OSL: " << P::osl << endl;
+    cout << "CONC values: " << join_ints(P::conc_values, num_conc) << endl;
+    cout << "============================================" << endl;
+    
+    vector<ScoreEntry> entries;
+    ScoreEntry baseline;
+    baseline.name = "baseline";
+    for (const BaselineTarget& b : P::baselines) {
+        if (b.isl == P::isl && b.osl == P::osl) {
+            baseline.points[b.conc] = {b.tput_per_gpu, b.median_intvty, b.median_e2e};
+        }
+    }
+    entries.push_back(baseline);
+    
+    for (const string& input : cfg.mode_inputs) {
+        ScoreEntry entry;
+        string path;
+        entry.name = score_entry_name(input, path);
+        vector<string> files = list_result_files(path);
+        if (files.empty()) {
+            cerr << "ERROR: No result files found in " << path << endl;
+            return 1;
+        }
+        for (const string& file : files) {
+            RunResult run;
+            if (!load_run_result(file, run)) return 1;
+            if (run.isl != P::isl || run.osl != P::osl) {
+                cout << "WARNING: Skipping " << file << " (ISL=" << run.isl << ", OSL=" << run.osl << ")" << endl;
+                continue;
+            }
+            if (entry.points.count(run.conc)) {
+                cout << "WARNING: " << entry.name << " has several CONC=" << run.conc << " results, using " << file
+                     << endl;
+            }
+            entry.points[run.conc] = {run.tput_per_gpu, run.interactivity, run.median_e2e_ms};
+        }
+        for (int conc : conc_values) {
+            if (!entry.points.count(conc)) {
+                cout << "WARNING: " << entry.name << " has no CONC=" << conc << " result and scores 0 there" << endl;
+            }
+        }
+        entries.push_back(entry);
+    }
+    
+    vector<ScoreStanding> standings = score_entries(entries, conc_values);
+    map<string, const ScoreEntry*> by_name;
+    for (const ScoreEntry& e : entries) by_name[e.name] = &e;
+    size_t name_width = 8;
+    for (const ScoreEntry& e : entries) name_width = max(name_width, e.name.size());
+    
+    for (int conc : conc_values) {
+        vector<const ScoreStanding*> order;
+        for (const ScoreStanding& s : standings) {
+            auto it = s.placings.find(conc);
+            if (it != s.placings.end() && it->second.present) order.push_back(&s);
+        }
+        sort(order.begin(), order.end(), [conc](const ScoreStanding* a, const ScoreStanding* b) {
+            return a->placings.at(conc).place < b->placings.at(conc).place;
+        });
+        cout << endl;
+        cout << "CONC=" << conc << " (tput/GPU, interactivity, E2E; curve = curve dominance front, "
+             << "layer = point dominance front, score = 50/30/20)" << endl;
+        for (const ScoreStanding* s : order) {
+            const ScorePlacing& pl = s->placings.at(conc);
+            const ScorePoint& pt = by_name[s->name]->points.at(conc);
+            cout << "  #" << left << setw(3) << pl.place << setw(name_width + 2) << s->name << right << setw(5)
+                 << pl.points << " pts  curve " << s->curve_layer << "  layer " << pl.layer << "  score " << fixed << setprecision(3) << pl.weighted
+                 << "  " << setprecision(1) << setw(9) << pt.tput_per_gpu << " tok/s/GPU  " << setw(7)
+                 << pt.interactivity << " tok/s/user  " << setprecision(2) << setw(7) << pt.median_e2e_ms / 1000.0
+                 << " s" << endl;
+        }
+    }
+    
+    cout << endl;
+    cout << "============================================" << endl;
+    cout << "Ranking (sum over CONC " << join_ints(P::conc_values, num_conc) << ")" << endl;
+    cout << "============================================" << endl;
+    for (size_t r = 0; r < standings.size(); r++) {
+        const ScoreStanding& s = standings[r];
+        stringstream per_conc;
+        for (size_t c = 0; c < conc_values.size(); c++) {
+            auto it = s.placings.find(conc_values[c]);
+            per_conc << (c ? " / " : "") << (it != s.placings.end() ? it->second.points : 0);
+        }
+        cout << "  #" << left << setw(3) << r + 1 << setw(name_width + 2) << s.name << right << setw(5) << s.total
+             << " pts  curve " << s.curve_layer << "  (" << per_conc.str() << ")" << endl;
+    }
+    cout << "============================================" << endl;
+    return 0;
+}
+
+// ============================================
+// Recover Mode
+// ============================================
+// Rebuilds the result summary of a run that crashed before writing it from
+// its journal, in the layout process_result_json uses (so `score` and
+// load_run_result read it), minus what needs the GPU layout or the accuracy
+// gate. The output goes next to the journal as <result>.recovered.json,
+// leaving any existing result file alone.
+inline int run_recover_mode(const Config& cfg) {
+    const string suffix = ".journal.jsonl";
+    int rc = 0;
+    for (const string& journal : cfg.mode_inputs) {
+        string base = journal;
+        if (base.size() > suffix.size() && base.compare(base.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            base.resize(base.size() - suffix.size());
+        }
+        string out_file = base + ".recovered.json";
+        
+        BenchmarkResult res;
+        JsonValue header;
+        if (recover_from_journal(journal, res, &header) != 0) {
+            rc = 1;
+            continue;
+        }
+        
+        JsonValue summary = benchmark_summary_json(res);
+        JsonValue args = JsonValue::object();
+        args.set("model", header["model"].as_string());
+        args.set("dataset_name", "random");
+        args.set("random_input_len", header["isl"].as_int());
+        args.set("random_output_len", header["osl"].as_int());
+        args.set("num_prompts", header["num_prompts"].as_int());
+        args.set("max_concurrency", header["max_concurrency"].as_int());
+        args.set("request_rate", request_rate_json(res.arrival));
+        args.set("arrival_mode", res.arrival.mode);
+        args.set("burstiness", res.arrival.burstiness);
+        args.set("prompt_format", res.prompt_format);
+        summary.set("benchmark_args", args);
+        summary.set("failed_requests", res.failed);
+        summary.set("interactivity", res.median_tpot_ms > 0 ? 1000.0 / res.median_tpot_ms : 0.0);
+        summary.set("recovered_from", journal);
+        
+        ofstream out(out_file);
+        out << summary.dump(2);
+        out.close();
+        if (out) {
+            cout << "INFO: Recovered result saved to " << out_file << endl;
+        } else {
+            cerr << "ERROR: Failed to write " << out_file << endl;
+            rc = 1;
+        }
+    }
+    return rc;
+}
+
+// ============================================
+// Main Function
+// ============================================
+template <typename P>
+int track_main(int argc, char** argv) {
+    static_assert(check_track_profile<P>(), "invalid track profile");
+    
+    Config cfg;
+    cfg.conc = P::default_conc;
+    cfg.isl = P::isl;
+    cfg.osl = P::osl;
+    cfg.max_model_len = P::max_model_len;
+    
+    cfg.script_dir = get_executable_dir();
+    
+    int i = 1;
+    while (i < argc) {
+        string arg = argv[i];
+        
+        if (cfg.mode.empty() && (arg == "acc" || arg == "perf" || arg == "submit" || arg == "score" ||
+                                 arg == "recover")) {
+            cfg.mode = arg;
+            i++;
+        } else if (arg == "-isl" || arg == "--isl") {
+            if (i + 1 < argc) {
+                cfg.isl_arg = argv[i + 1];
+                i += 2;
+            } else {
+                cerr << "ERROR: -isl requires an argument" << endl;
+                return 1;
+            }
+        } else if (arg == "-osl" || arg == "--osl") {
+            if (i + 1 < argc) {
+                cfg.osl_arg = argv[i + 1];
+                i += 2;
+            } else {
+                cerr << "ERROR: -osl requires an argument" << endl;
+                return 1;
+            }
+        } else if (arg == "-conc" || arg == "--conc") {
+            if (i + 1 < argc) {
+                cfg.conc_arg = argv[i + 1];
+                i += 2;
+            } else {
+                cerr << "ERROR: -conc requires an argument" << endl;
+                return 1;
+            }
+        } else if (arg == "--preset") {
+            if (i + 1 < argc) {
+                cfg.preset = argv[i + 1];
+                i += 2;
+            } else {
+                cerr << "ERROR: --preset requires an argument (leaderboard, curve)" << endl;
+                return 1;
+            }
+        } else if (arg == "--resume") {
+            if (i + 1 < argc) {
+                cfg.resume_dir = argv[i + 1];
+                i += 2;
+            } else {
+                cerr << "ERROR: --resume requires a batch directory" << endl;
+                return 1;
+            }
+        } else if (arg == "--plan") {
+            cfg.plan_only = true;
+            i++;
+        } else if (cfg.mode == "score" || cfg.mode == "recover") {
+            cfg.mode_inputs.push_back(arg);
+            i++;
+        } else {
+            if (cfg.mode == "submit" && cfg.team_name.empty()) {
+                cfg.team_name = arg;
+            }
+            i++;
+        }
+    }
+    
+    if (cfg.mode.empty()) {
+        cfg.mode = "acc";
+    }
+    
+    if (cfg.mode != "acc" && cfg.mode != "perf" && cfg.mode != "submit" && cfg.mode != "score" &&
+        cfg.mode != "recover") {
+        cerr << "ERROR: Invalid mode '" << cfg.mode << "'" << endl;
+        cerr << "Usage:" << endl;
+        cerr << "  " << argv[0] << " acc [-isl <list>] [-osl <list>] [-conc <list>] [--preset <name>] [--plan]" << endl;
+        cerr << "  " << argv[0] << " perf [-isl <list>] [-osl <list>] [-conc <list>] [--preset <name>] [--plan]" << endl;
+        cerr << "  " << argv[0] << " submit <team> [-isl <value>] [-osl <value>]" << endl;
+        cerr << "  " << argv[0] << " perf|submit [<team>] --resume <batch_dir>" << endl;
+        cerr << "  " << argv[0] << " score <batch_dir|result.json|name=path>..." << endl;
+        cerr << "  " << argv[0] << " recover <result>.journal.jsonl..." << endl;
+        return 1;
+    }
+    
+    if (cfg.mode == "score") {
+        if (cfg.mode_inputs.empty()) {
+            cerr << "ERROR: score mode needs at least one batch directory or result file" << endl;
+            cerr << "Usage: " << argv[0] << " score <batch_dir|result.json|name=path>..." << endl;
+            return 1;
+        }
+        return run_score_mode<P>(cfg);
+    }
+    
+    if (cfg.mode == "recover") {
+        if (cfg.mode_inputs.empty()) {
+            cerr << "ERROR: recover mode needs a result journal" << endl;
+            cerr << "Usage: " << argv[0] << " recover <result>.journal.jsonl..." << endl;
+            return 1;
+        }
+        return run_recover_mode(cfg);
+    }
+    
+    if (cfg.mode == "submit") {
+        if (cfg.team_name.empty()) {
+            cfg.team_name = get_env_var("TEAM_NAME_ENV");
+            if (cfg.team_name.empty()) {
+                cerr << "ERROR: Team name required for submit mode" << endl;
+                cerr << "Usage: " << argv[0] << " submit <team_name> [-isl <value>] [-osl <value>]" << endl;
+                cerr << "Or set TEAM_NAME_ENV environment variable" << endl;
+                return 1;
+            }
+        }
+    }
+    
+    cfg.multi_conc_mode = (!cfg.isl_arg.empty() && !cfg.osl_arg.empty()) || !cfg.conc_arg.empty() ||
+                          !cfg.preset.empty() || cfg.plan_only || !cfg.resume_dir.empty();
+    
+    if (load_env_config<P>(cfg, cfg.multi_conc_mode) != 0) {
+        return 1;
+    }
+    
+    if (cfg.multi_conc_mode) {
+        return run_multi_conc_mode<P>(cfg);
+    }
+    
+    // Single Configuration Mode
+    print_config(cfg);
+    
+    if (cfg.mode == "submit" && cfg.lb_url_override.empty() && get_leaderboard_url<P>(cfg.isl, cfg.osl).empty()) {
+        cerr << "ERROR: The leaderboard only ranks ISL=" << P::isl << ", OSL=" << P::osl << endl;
+        return 1;
+    }
+    
+    AccuracyMetrics acc_metrics;
+    if (run_accuracy_test<P>(cfg, acc_metrics) != 0) {
+        return 1;
+    }
+    
+    if (validate_accuracy<P>(acc_metrics) != 0) {
+        return 1;
+    }
+    
+    return run_single_test<P>(cfg, acc_metrics);
+}
+
+}  // namespace track
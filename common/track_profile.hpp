@@ -0,0 +1,152 @@
+// ============================================
+// Track Profiles
+// ============================================
+// Everything that differs between the competition binaries, as compile-time
+// constants. A track binary is one model track (GPT-OSS Track 1, DeepSeek-R1
+// MTP Track 2) served by one backend (vLLM, ATOM, SGLang):
+//
+//   struct Profile : TrackProfile<GptOssTrack1, VllmBackend> {};
+//
+// and the shared engine (track_engine.hpp) is instantiated for it. The
+// baselines, CONC set and defaults of every profile are checked when it is
+// compiled, so a missing target fails the build instead of a submission.
+
+#pragma once
+
+#include <cstddef>
+
+// Grand Prize targets (README): e2e ms, interactivity token/s/user, tput token/s/GPU
+struct BaselineTarget {
+    int isl;
+    int osl;
+    int conc;
+    double median_e2e;
+    double median_intvty;
+    double tput_per_gpu;
+};
+
+template <size_t N>
+constexpr const BaselineTarget* find_baseline(const BaselineTarget (&table)[N], int isl, int osl, int conc) {
+    for (size_t i = 0; i < N; i++) {
+        if (table[i].isl == isl && table[i].osl == osl && table[i].conc == conc) return &table[i];
+    }
+    return nullptr;
+}
+
+// ============================================
+// Model Tracks
+// ============================================
+struct GptOssTrack1 {
+    static constexpr const char* track_name = "GPT-OSS FP4 (Track 1)";
+    static constexpr const char* example_model = "openai/gpt-oss-120b";
+    static constexpr const char* leaderboard_url = "https://daniehua-gptoss-fp4-isl8192osl1024.hf.space";
+    static constexpr int isl = 8192;
+    static constexpr int osl = 1024;
+    static constexpr int max_model_len = 16384;     // exported to the server; 0 = not used
+    static constexpr int conc_values[] = {4, 32, 128};
+    static constexpr int default_conc = 4;
+    static constexpr int prompts_per_conc = 10;     // NUM_PROMPTS = CONC * 10
+    static constexpr double gsm8k_baseline = 0.38;  // GSM8K_BASELINE_METRIC default
+    static constexpr BaselineTarget baselines[] = {
+        {8192, 1024, 4, 3500, 270, 9500},           // e2e ≤ 3.5 s, interactivity ≥ 270, throughput ≥ 9500
+        {8192, 1024, 32, 6000, 150, 21500},         // e2e ≤ 6 s, interactivity ≥ 150, throughput ≥ 21500
+        {8192, 1024, 128, 21000, 40, 50600},        // e2e ≤ 21 s, interactivity ≥ 40, throughput ≥ 50600
+    };
+};
+
+struct DeepSeekR1MtpTrack2 {
+    static constexpr const char* track_name = "DeepSeek-R1-0528 FP4 + MTP (Track 2)";
+    static constexpr const char* example_model = "amd/DeepSeek-R1-0528-MXFP4";
+    static constexpr const char* leaderboard_url = "https://daniehua-dsr1-fp4-isl8192osl1024.hf.space";
+    static constexpr int isl = 8192;
+    static constexpr int osl = 1024;
+    static constexpr int max_model_len = 0;
+    static constexpr int conc_values[] = {4, 32, 128};
+    static constexpr int default_conc = 4;
+    static constexpr int prompts_per_conc = 10;     // match InferenceX: CONC * 10
+    static constexpr double gsm8k_baseline = 0.93;
+    static constexpr BaselineTarget baselines[] = {
+        {8192, 1024, 4, 5000, 165, 1500},           // e2e ≤ 5 s, interactivity ≥ 165, throughput ≥ 1500
+        {8192, 1024, 32, 18000, 50, 3900},          // e2e ≤ 18 s, interactivity ≥ 50, throughput ≥ 3900
+        {8192, 1024, 128, 22000, 48, 6000},         // e2e ≤ 22 s, interactivity ≥ 48, throughput ≥ 6000
+    };
+};
+
+// ============================================
+// Backend Adapters
+// ============================================
+// All three serve the OpenAI API; `backend` is what benchmark_args records.
+struct VllmBackend {
+    static constexpr const char* server_name = "vLLM";
+    static constexpr const char* backend = "vllm";
+    static constexpr bool use_chat_template = false;
+    static constexpr bool sglang_native = false;
+};
+
+struct AtomBackend {
+    static constexpr const char* server_name = "ATOM";
+    static constexpr const char* backend = "atom";
+    static constexpr bool use_chat_template = false;
+    static constexpr bool sglang_native = false;
+};
+
+struct SglangBackend {
+    static constexpr const char* server_name = "SGLang";
+    static constexpr const char* backend = "vllm";      // OpenAI-compatible client, as benchmark_serving calls it
+    static constexpr bool use_chat_template = false;
+    static constexpr bool sglang_native = true;     // token_ids prompts go to /generate
+};
+
+// ============================================
+// Profile
+// ============================================
+// A profile may shadow any constant of its track or backend, e.g.
+// use_chat_template for a reasoning model served through ATOM.
+template <typename Track, typename Backend>
+struct TrackProfile : Track, Backend {};
+
+template <typename P>
+constexpr bool profile_baselines_cover_conc_set() {
+    for (int conc : P::conc_values) {
+        if (!find_baseline(P::baselines, P::isl, P::osl, conc)) return false;
+    }
+    return true;
+}
+
+template <typename P>
+constexpr bool profile_conc_set_ascending() {
+    int prev = 0;
+    for (int conc : P::conc_values) {
+        if (conc <= prev) return false;
+        prev = conc;
+    }
+    return true;
+}
+
+template <typename P>
+constexpr bool profile_conc_set_contains(int conc) {
+    for (int c : P::conc_values) {
+        if (c == conc) return true;
+    }
+    return false;
+}
+
+template <typename P>
+constexpr bool profile_baselines_positive() {
+    for (const BaselineTarget& b : P::baselines) {
+        if (b.median_e2e <= 0 || b.median_intvty <= 0 || b.tput_per_gpu <= 0) return false;
+    }
+    return true;
+}
+
+template <typename P>
+constexpr bool check_track_profile() {
+    static_assert(profile_conc_set_ascending<P>(), "CONC set must be positive and strictly ascending");
+    static_assert(profile_conc_set_contains<P>(P::default_conc), "default CONC must be in the CONC set");
+    static_assert(profile_baselines_cover_conc_set<P>(), "every CONC in the set needs a baseline target");
+    static_assert(profile_baselines_positive<P>(), "baseline targets must be positive");
+    static_assert(P::prompts_per_conc > 0, "prompts_per_conc must be positive");
+    static_assert(P::gsm8k_baseline > 0 && P::gsm8k_baseline < 1, "GSM8K baseline is a fraction");
+    static_assert(!P::sglang_native || !P::use_chat_template, "/generate takes no chat template");
+    return true;
+}
@@ -0,0 +1,263 @@
+// ============================================
+// Load Generator Workload
+// ============================================
+// Configuration, request/result records, random dataset and request bodies
+// shared by the client engine (sharded_client.hpp) and the load generator
+// front end (loadgen.hpp).
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "adaptive_sampling.hpp"
+#include "arrival.hpp"
+
+// ============================================
+// Load Generator Configuration
+// ============================================
+struct LoadGenConfig {
+    std::string model;
+    std::string base_url;                       // e.g. http://0.0.0.0:8888
+    // Several server instances (data-parallel replicas): one URL each.
+    // Connection slots are spread over them round-robin; empty = base_url.
+    std::vector<std::string> instance_urls;
+    bool use_chat_template = false;             // /v1/chat/completions instead of /v1/completions
+    // "text" sends the random prompt as words for the server to tokenize;
+    // "token_ids" sends pre-tokenized ids so every request carries exactly
+    // the sampled length and no tokenizer time lands in TTFT.
+    std::string prompt_format = "text";
+    bool sglang_native = false;                 // token_ids go to SGLang's /generate as input_ids
+    int token_id_lo = 1000;                     // sampled id range: ordinary BPE tokens in both
+    int token_id_hi = 100000;                   // the GPT-OSS and DeepSeek vocabularies
+    int isl = 8192;
+    int osl = 1024;
+    double random_range_ratio = 1.0;
+    int num_prompts = 0;
+    int max_concurrency = 1;
+    int num_warmups = 0;
+    unsigned int seed = 0;                      // prompt stream; see prompt_seed()
+    ArrivalConfig arrival;                      // default: request rate inf
+    // Which latency the headline ttft/e2el fields report: "service" (from the
+    // actual send) or "response_time" (from the intended send time; open-loop
+    // arrival modes only).
+    std::string latency_definition = "service";
+    int hist_significant_digits = 3;            // HDR histogram precision (1-5)
+    double steady_tolerance = 0.15;             // steady window: max per-bin deviation from median throughput
+    int client_threads = 0;                     // worker threads; 0 = auto
+    bool pin_client_threads = true;             // pin workers to distinct CPUs
+    std::string journal_path;                   // per-request JSONL journal of the measured run; empty = off
+    int journal_sync_every = 64;                // records per fsync
+    AdaptiveSampling adaptive;                  // stop once the headline metrics converge; num_prompts is the cap
+};
+
+inline bool is_valid_latency_definition(const std::string& def) {
+    return def == "service" || def == "response_time";
+}
+
+inline bool is_valid_prompt_format(const std::string& format) {
+    return format == "text" || format == "token_ids";
+}
+
+// ============================================
+// Per-Request Result
+// ============================================
+struct RequestResult {
+    bool success = false;
+    std::string error;
+    int prompt_len = 0;                         // server-reported when usage is streamed
+    int output_len = 0;
+    double first_byte_ms = 0.0;                 // first response byte, from send
+    double ttft_ms = 0.0;
+    double e2el_ms = 0.0;
+    std::vector<double> itl_ms;
+    std::vector<int32_t> chunk_tokens;          // tokens per streamed chunk, itl_ms.size() + 1 entries
+    // Coordinated-omission accounting: how long after its intended send time
+    // the request actually went out. Response time = service latency + lag.
+    double intended_start_s = 0.0;              // offset from the start of the run
+    double send_lag_ms = 0.0;
+    double send_time_s = 0.0;                   // actual send, offset from the start of the run
+    int slot = -1;                              // client connection slot that carried it
+};
+
+// ============================================
+// Helpers
+// ============================================
+inline std::string loadgen_json_escape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+// numpy.percentile (linear interpolation) over an unsorted copy.
+inline double loadgen_percentile(std::vector<double> values, double pct) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double rank = pct / 100.0 * (values.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(rank));
+    size_t hi = static_cast<size_t>(std::ceil(rank));
+    return values[lo] + (values[hi] - values[lo]) * (rank - lo);
+}
+
+inline double loadgen_mean(const std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return sum / values.size();
+}
+
+// ============================================
+// Random Dataset
+// ============================================
+// benchmark_serving.py decodes random token ids with the model tokenizer. We
+// have no tokenizer here, so prompts are built from common English words that
+// are a single token (with leading space) in the GPT-OSS and DeepSeek vocabularies.
+// The exact prompt length the server saw is taken from the streamed `usage`.
+static const char* const LOADGEN_WORDS[] = {
+    "the", "of", "and", "to", "in", "is", "was", "for", "on", "that", "with", "as", "by",
+    "at", "from", "his", "her", "they", "this", "which", "or", "an", "are", "had", "not",
+    "but", "have", "one", "were", "their", "been", "has", "all", "more", "when", "who",
+    "will", "would", "there", "about", "time", "into", "first", "also", "after", "new",
+    "some", "year", "two", "people", "city", "can", "only", "other", "such", "over",
+    "many", "most", "these", "may", "could", "state", "world", "school", "during", "work",
+    "water", "house", "light", "river", "music", "power", "game", "field", "line", "small",
+    "large", "early", "long", "great", "high", "left", "right", "name", "part", "place",
+    "group", "number", "system", "family", "home", "war", "day", "life", "book", "film",
+    "story", "road", "form", "south", "north", "east", "west", "white", "black", "red",
+    "green", "blue", "old", "young", "king", "church", "team", "club", "party", "army",
+};
+static const size_t LOADGEN_NUM_WORDS = sizeof(LOADGEN_WORDS) / sizeof(LOADGEN_WORDS[0]);
+
+struct PromptSpec {
+    std::string prompt;
+    std::vector<int32_t> token_ids;     // prompt_format "token_ids" only
+    int prompt_len = 0;        // requested length in tokens
+    int output_len = 0;
+};
+
+// Seed of a run's prompt stream, distinct per (ISL, OSL, CONC). With one
+// seed for every point, a sweep's CONC=32 run would open with the very prompts
+// CONC=4 just sent, and the server's prefix cache (on by default in vLLM and
+// SGLang) would serve their prefill. Rerunning a point still sends the same
+// prompts.
+inline unsigned int prompt_seed(int isl, int osl, int conc) {
+    uint32_t h = 2166136261u;
+    for (int v : {isl, osl, conc}) {
+        for (int b = 0; b < 4; b++) {
+            h ^= static_cast<uint32_t>(v >> (8 * b)) & 0xff;
+            h *= 16777619u;
+        }
+    }
+    return h;
+}
+
+inline std::vector<PromptSpec> generate_random_prompts(const LoadGenConfig& cfg) {
+    std::mt19937 rng(cfg.seed);
+    int in_lo = static_cast<int>(cfg.isl * cfg.random_range_ratio);
+    int out_lo = static_cast<int>(cfg.osl * cfg.random_range_ratio);
+    std::uniform_int_distribution<int> in_dist(std::min(in_lo, cfg.isl), cfg.isl);
+    std::uniform_int_distribution<int> out_dist(std::min(out_lo, cfg.osl), cfg.osl);
+    std::uniform_int_distribution<size_t> word_dist(0, LOADGEN_NUM_WORDS - 1);
+    std::uniform_int_distribution<int32_t> id_dist(cfg.token_id_lo, std::max(cfg.token_id_lo, cfg.token_id_hi - 1));
+    bool token_ids = cfg.prompt_format == "token_ids";
+
+    std::vector<PromptSpec> prompts(std::max(0, cfg.num_prompts));
+    for (auto& p : prompts) {
+        p.prompt_len = in_dist(rng);
+        p.output_len = out_dist(rng);
+        if (token_ids) {
+            p.token_ids.resize(p.prompt_len);
+            for (auto& id : p.token_ids) id = id_dist(rng);
+            continue;
+        }
+        p.prompt.reserve(p.prompt_len * 6);
+        for (int j = 0; j < p.prompt_len; j++) {
+            if (j > 0) p.prompt += ' ';
+            p.prompt += LOADGEN_WORDS[word_dist(rng)];
+        }
+    }
+    return prompts;
+}
+
+// Server a connection slot talks to; a slot stays on one instance so its
+// keep-alive connection is reused.
+inline const std::string& slot_base_url(const LoadGenConfig& cfg, int slot) {
+    return cfg.instance_urls.empty() ? cfg.base_url : cfg.instance_urls[slot % cfg.instance_urls.size()];
+}
+
+// Endpoint path for one request, relative to base_url.
+inline const char* request_path(const LoadGenConfig& cfg) {
+    if (cfg.prompt_format == "token_ids") return cfg.sglang_native ? "/generate" : "/v1/completions";
+    return cfg.use_chat_template ? "/v1/chat/completions" : "/v1/completions";
+}
+
+inline void append_token_ids(std::string& out, const std::vector<int32_t>& ids) {
+    char buf[16];
+    out += '[';
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (i) out += ',';
+        auto r = std::to_chars(buf, buf + sizeof(buf), ids[i]);
+        out.append(buf, r.ptr);
+    }
+    out += ']';
+}
+
+inline std::string build_request_body(const LoadGenConfig& cfg, const PromptSpec& p) {
+    if (cfg.prompt_format == "token_ids") {
+        // Token ids bypass any chat template: the ids are the exact prompt.
+        std::string body;
+        body.reserve(p.token_ids.size() * 7 + 256);
+        if (cfg.sglang_native) {
+            body += "{\"input_ids\": ";
+            append_token_ids(body, p.token_ids);
+            body += ", \"sampling_params\": {\"temperature\": 0.0, \"max_new_tokens\": " +
+                    std::to_string(p.output_len) + ", \"ignore_eos\": true}, \"stream\": true}";
+        } else {
+            body += "{\"model\": \"" + loadgen_json_escape(cfg.model) + "\", \"prompt\": ";
+            append_token_ids(body, p.token_ids);
+            body += ", \"temperature\": 0.0, \"max_tokens\": " + std::to_string(p.output_len) +
+                    ", \"ignore_eos\": true, \"stream\": true, \"stream_options\": {\"include_usage\": true}}";
+        }
+        return body;
+    }
+
+    std::stringstream body;
+    body << "{\"model\": \"" << loadgen_json_escape(cfg.model) << "\", ";
+    if (cfg.use_chat_template) {
+        body << "\"messages\": [{\"role\": \"user\", \"content\": \""
+             << loadgen_json_escape(p.prompt) << "\"}], ";
+    } else {
+        body << "\"prompt\": \"" << loadgen_json_escape(p.prompt) << "\", ";
+    }
+    body << "\"temperature\": 0.0, "
+         << "\"max_tokens\": " << p.output_len << ", "
+         << "\"ignore_eos\": true, "
+         << "\"stream\": true, "
+         << "\"stream_options\": {\"include_usage\": true}}";
+    return body.str();
+}
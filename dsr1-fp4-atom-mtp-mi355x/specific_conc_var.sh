@@ -9,3 +9,5 @@ export NUM_PROMPTS=$((CONC * 10))
 export RESULT_FILENAME="test_$(date +%H%M%S)"
 export EP_SIZE=1
 export DP_ATTENTION=0
+# Load generator knobs (arrival process, latency definition, adaptive sampling, ...)
+source "$(dirname "${BASH_SOURCE[0]}")/../common/loadgen_env.sh"
@@ -8,3 +8,5 @@ export CONC=4
 export RANDOM_RANGE_RATIO=1.0
 export NUM_PROMPTS=$((CONC * 10))
 export RESULT_FILENAME="test_$(date +%H%M%S)"
+# Load generator knobs (arrival process, latency definition, adaptive sampling, ...)
+source "$(dirname "${BASH_SOURCE[0]}")/../common/loadgen_env.sh"
@@ -35,6 +35,10 @@ export CONC=4
 
 export RANDOM_RANGE_RATIO=1.0
 export NUM_PROMPTS=$(( CONC * 10 ))
+
+# Load generator knobs (arrival process, latency definition, adaptive sampling, ...)
+source "$(dirname "${BASH_SOURCE[0]}")/../common/loadgen_env.sh"
+
 export RESULT_FILENAME="result_isl${ISL}_osl${OSL}_conc${CONC}"
 
 # ============================================
@@ -41,6 +41,9 @@ export RANDOM_RANGE_RATIO=1.0
 # Number of Prompts (GPT-OSS: CONC * 10)
 export NUM_PROMPTS=$(( CONC * 10 ))
 
+# Load generator knobs (arrival process, latency definition, adaptive sampling, ...)
+source "$(dirname "${BASH_SOURCE[0]}")/../common/loadgen_env.sh"
+
 # Result Filename
 export RESULT_FILENAME="result_isl${ISL}_osl${OSL}_conc${CONC}"
 